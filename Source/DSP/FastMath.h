@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cstring>
+
+// 오디오 스레드에서 자주 부르는 초월 함수의 빠른 근사.
+namespace FastMath {
+// 2^x 근사. x = n + f (n 은 가장 가까운 정수, |f| <= 0.5) 로 나눠
+// 2^n 은 지수 비트로 바로 만들고 2^f 는 4차 최소최대 다항식으로 구합니다.
+// 최대 상대 오차 3.5e-6 (약 0.006 센트)으로 음정 계산에는 충분합니다.
+//
+// floor 대신 양수로 옮긴 뒤 정수 변환(버림)을 쓰고, 그 정수가 곧
+// 바이어스가 더해진 지수이므로 분기와 라이브러리 호출이 없어
+// 아래 블록 버전의 루프가 그대로 벡터화됩니다. 같은 이유로 범위를
+// 자르지 않으니 |x| < 126 인 입력에만 씁니다 (음정은 수 옥타브 이내).
+inline float exp2(float x) {
+  const auto biased = (juce::int32)(x + 127.5f); // round(x) + 127
+  const float f = x - (float)(biased - 127);
+  const float p =
+      1.0f + f * (0.693121045f +
+                  f * (0.240223490f + f * (0.0559219758f + f * 0.00966636852f)));
+
+  const juce::int32 bits = biased << 23;
+  float scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return p * scale;
+}
+
+// 블록 단위 2^x. 제자리 변환(source == dest)도 됩니다.
+inline void exp2(const float *source, float *dest, int numSamples) {
+  for (int i = 0; i < numSamples; ++i)
+    dest[i] = exp2(source[i]);
+}
+
+// 반음을 피치 비율로: 2^(semitones / 12)
+inline float semitonesToRatio(float semitones) {
+  return exp2(semitones * (1.0f / 12.0f));
+}
+} // namespace FastMath
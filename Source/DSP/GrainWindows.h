@@ -0,0 +1,131 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// 그레인 윈도우 형태와 헤드 수
+enum class WindowShape { triangle, hann, tukey };
+constexpr int numWindowShapes = 3;
+
+// 지원하는 읽기 헤드 수 (파라미터 선택지 순서와 같습니다)
+constexpr std::array<int, 4> grainHeadCounts{2, 3, 4, 8};
+constexpr int maxGrainHeads = 8;
+
+// 그레인 윈도우 게인 정책. 위상 x(0..1)에 대한 게인을 돌려주며
+// 커널 템플릿 인자로 쓰여 내부 루프에서 분기 없이 인라인됩니다.
+namespace GrainWindows {
+
+// 삼각형 윈도우: 0 -> 0, 0.5 -> 1, 1 -> 0
+// 반 바퀴 오프셋된 두 삼각형 윈도우의 합은 항상 1이고, 짝수 N개를
+// 균등하게 오프셋하면 합이 N/2 이므로 짝수 헤드는 테이블 없이 계산합니다.
+struct Triangle {
+  static constexpr bool tabulated = false;
+  static float gain(float x, const float *) {
+    return 1.0f - std::abs(2.0f * x - 1.0f);
+  }
+};
+
+// Hann 윈도우: sin^2(pi x). 균등하게 오프셋된 N(>= 2)개의 합은 항상 N/2
+// 이므로 어떤 헤드 수든 테이블 없이 계산하고 2/N 배율만 곱합니다.
+// y = x - 0.5 로 옮기면 cos^2(pi y) = (1 + cos(2 pi y)) / 2 이고, 이를 y^2 의
+// 8차 테일러 다항식으로 구합니다 (|y| <= 0.5 에서 최대 오차 약 2.5e-7).
+// 분기도 테이블 읽기도 없어 램프 루프가 그대로 벡터화됩니다.
+struct Hann {
+  static constexpr bool tabulated = false;
+  static float gain(float x, const float *) {
+    const float y = x - 0.5f;
+    const float u = y * y;
+    return 1.0f +
+           u * (-9.86960440f +
+                u * (32.4696970f +
+                     u * (-42.7284086f +
+                          u * (30.1223207f +
+                               u * (-13.2131284f +
+                                    u * (3.95176819f +
+                                         u * (-0.857195356f +
+                                              u * 0.141002984f)))))));
+  }
+};
+
+// 해석적 윈도우(삼각형은 짝수 헤드, Hann 은 모든 헤드 수)의 합을 1로
+// 맞추는 배율. 테이블을 읽는 조합이면 0 을 돌려줍니다.
+inline float analyticScale(WindowShape shape, int numHeads) {
+  if (shape == WindowShape::hann || (shape == WindowShape::triangle &&
+                                     numHeads % 2 == 0))
+    return 2.0f / (float)numHeads;
+
+  return 0.0f;
+}
+
+// 그 외 형태/헤드 수 조합은 미리 계산된 테이블을 선형 보간으로 읽습니다.
+// 테이블은 헤드 수만큼 균등하게 오프셋된 윈도우들의 합이 1이 되도록
+// 정규화되어 있어 어떤 조합에서도 출력 레벨이 일정합니다.
+constexpr int tableSize = 1024;
+
+struct Tabulated {
+  static constexpr bool tabulated = true;
+  static float gain(float x, const float *table) {
+    const float pos = x * (float)tableSize;
+    const int i = (int)pos;
+    return table[i] + (pos - (float)i) * (table[i + 1] - table[i]);
+  }
+};
+
+inline double shapeAt(WindowShape shape, double x) {
+  switch (shape) {
+  case WindowShape::hann:
+    return 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * x);
+  case WindowShape::tukey: {
+    // 양 끝 25%씩 코사인 테이퍼, 가운데는 평탄 (alpha = 0.5)
+    constexpr double alpha = 0.5;
+    const double edge = juce::jmin(x, 1.0 - x);
+    if (edge >= alpha * 0.5)
+      return 1.0;
+    return 0.5 - 0.5 * std::cos(juce::MathConstants<double>::pi * edge /
+                                 (alpha * 0.5));
+  }
+  case WindowShape::triangle:
+  default:
+    return 1.0 - std::abs(2.0 * x - 1.0);
+  }
+}
+
+// 모든 형태 x 헤드 수 조합의 정규화 테이블. 인스턴스 간에 공유됩니다.
+struct Tables {
+  Tables() {
+    for (int s = 0; s < numWindowShapes; ++s) {
+      for (size_t h = 0; h < grainHeadCounts.size(); ++h) {
+        const int numHeads = grainHeadCounts[h];
+        auto &table = data[(size_t)s * grainHeadCounts.size() + h];
+
+        // 끝점(x == 1)까지 포함해 보간 시 i + 1 을 검사 없이 읽습니다.
+        for (int i = 0; i <= tableSize; ++i) {
+          const double x = (double)i / tableSize;
+          double overlap = 0.0;
+
+          for (int k = 0; k < numHeads; ++k)
+            overlap += shapeAt((WindowShape)s,
+                               std::fmod(x + (double)k / numHeads, 1.0));
+
+          table[(size_t)i] =
+              (float)(shapeAt((WindowShape)s, x) / juce::jmax(overlap, 1.0e-9));
+        }
+      }
+    }
+  }
+
+  std::array<std::array<float, tableSize + 1>,
+             numWindowShapes * grainHeadCounts.size()>
+      data;
+};
+
+// numHeads 는 grainHeadCounts 중 하나여야 합니다.
+inline const float *getTable(WindowShape shape, int numHeads) {
+  static const Tables tables;
+
+  size_t h = 0;
+  while (h + 1 < grainHeadCounts.size() && grainHeadCounts[h] != numHeads)
+    ++h;
+
+  return tables.data[(size_t)shape * grainHeadCounts.size() + h].data();
+}
+} // namespace GrainWindows
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// 2배 데시메이션과 보간, 그리고 같은 레이트 대역 분할을 위한 선형 위상
+// 하프밴드 FIR. juce::dsp::FilterDesign 의 등리플 하프밴드 설계는 가운데
+// 탭(0.5)을 뺀 짝수 거리의 탭이 모두 0 이므로, 대칭인 탭 쌍과 가운데 탭만
+// 계산합니다.
+//
+// 데시메이터는 원래 레이트 입력 두 개마다 하나를 내보내고, 보간기는 같은
+// 2:1 위상으로 원래 레이트 출력 두 개마다 하나를 받아 갑니다. 둘 다 reset
+// 에서 같은 위상으로 시작하므로 블록 크기가 홀수여도 데시메이터가 내보낸
+// 샘플 수와 보간기가 받아 가는 샘플 수가 블록마다 같습니다. 보간기만 쓰는
+// 인스턴스도 같은 위상으로 돌므로, 한 인스턴스로 내리고 다른 인스턴스로
+// 올려도 됩니다.
+// 데시메이션과 보간을 거친 지연은 원래 레이트로 정확히 N - 1 샘플입니다.
+//
+// 탭 루프는 쌍 수별로 펼친 커널 안에 두고 출력 루프를 벡터화합니다.
+// 데시메이터는 입력을 홀짝 위상 두 줄로 나눠 두어 커널이 연속된 메모리만
+// 읽게 합니다.
+class HalfbandFilter {
+public:
+  // normalisedTransitionWidth 는 나이퀴스트 대비 전이 대역의 반폭입니다.
+  // 0.25 면 원래 나이퀴스트의 1/4 까지 통과, 3/4 부터 stopbandDb 로 막습니다.
+  // maxBlockSize 는 원래 레이트 기준 한 번에 처리할 최대 샘플 수입니다.
+  void prepare(int numChannels, int maxBlockSize,
+               float normalisedTransitionWidth, float stopbandDb) {
+    auto coefficients =
+        juce::dsp::FilterDesign<float>::designFIRLowpassHalfBandEquirippleMethod(
+            normalisedTransitionWidth, stopbandDb);
+    const float *fir = coefficients->getRawCoefficients();
+
+    length = (int)coefficients->getFilterOrder() + 1;
+    centre = length / 2;
+    numPairs = (centre + 1) / 2;
+    jassert(length % 4 == 3); // 가운데 탭이 홀수 위치여야 위상이 맞습니다.
+
+    jassert(numPairs <= maxPairs);
+    numPairs = juce::jmin(numPairs, maxPairs);
+
+    for (int j = 0; j < numPairs; ++j) {
+      pairTaps[(size_t)j] = fir[2 * j];
+      interpolatorTaps[(size_t)j] = 2.0f * fir[2 * j];
+    }
+
+    kernel = selectKernel<1>(numPairs);
+    filterKernel = selectKernel<2>(numPairs);
+
+    // 상태 버퍼는 [지난 입력 | 이번 블록] 을 연속으로 담습니다.
+    // 데시메이터의 홀수 줄은 가운데 탭 거리만큼, 짝수 줄은 가운데 탭 하나와
+    // 블록이 홀수 위상에서 시작할 때의 한 샘플만큼 과거를 둡니다.
+    const int maxHalfBlock = maxBlockSize / 2 + 1;
+    oddHistory = centre;
+    evenHistory = (centre + 1) / 2;
+    oddState.setSize(numChannels, oddHistory + maxHalfBlock);
+    evenState.setSize(numChannels, evenHistory + maxHalfBlock);
+    interpolatorState.setSize(numChannels, centre + maxHalfBlock);
+    interpolatorSums.setSize(1, maxHalfBlock);
+    filterState.setSize(numChannels, length - 1 + maxBlockSize);
+    reset();
+  }
+
+  void reset() {
+    oddState.clear();
+    evenState.clear();
+    interpolatorState.clear();
+    filterState.clear();
+    decimatorPhase = 0;
+    interpolatorPhase = 0;
+  }
+
+  // 원래 레이트 기준 데시메이션 + 보간 지연
+  int getLatencySamples() const { return length - 1; }
+
+  // 같은 레이트로 거르는 filter 의 지연 (가운데 탭 위치)
+  int getFilterLatencySamples() const { return centre; }
+
+  // numSamples 개의 입력을 받아 절반 레이트 샘플을 output 에 쓰고 그 수를
+  // 돌려줍니다 (입력 위상에 따라 numSamples / 2 올림 또는 내림).
+  // 출력은 위상이 맞는 입력(두 개마다 하나) 바로 뒤에 나옵니다.
+  int decimate(const float *const *input, float *const *output,
+               int numChannels, int numSamples) {
+    // 스트림 위치가 홀수인 입력마다 출력이 하나 나옵니다. 출력 k 의 탭 쌍은
+    // 홀수 줄의 k - j 와 k - centre + j 를, 가운데 탭은 짝수 줄을 읽습니다.
+    const int firstOdd = 1 - decimatorPhase;
+    const int firstEven = decimatorPhase;
+    const int numOutput = countPhase(numSamples, firstOdd);
+    const int numEven = countPhase(numSamples, firstEven);
+    const int evenOffset = 1 - decimatorPhase;
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      const float *x = input[ch];
+      float *odd = oddState.getWritePointer(ch);
+      float *even = evenState.getWritePointer(ch);
+      float *y = output[ch];
+
+      for (int k = 0; k < numOutput; ++k)
+        odd[oddHistory + k] = x[firstOdd + 2 * k];
+      for (int k = 0; k < numEven; ++k)
+        even[evenHistory + k] = x[firstEven + 2 * k];
+
+      kernel(even + evenOffset, 0.5f, odd + centre, odd, pairTaps.data(), y,
+             numOutput);
+
+      std::memmove(odd, odd + numOutput, sizeof(float) * (size_t)oddHistory);
+      std::memmove(even, even + numEven, sizeof(float) * (size_t)evenHistory);
+    }
+
+    decimatorPhase = (decimatorPhase + numSamples) & 1;
+    return numOutput;
+  }
+
+  // 절반 레이트 input 을 받아 원래 레이트 numSamples 개를 output 에 씁니다.
+  // 받아 간 입력 수를 돌려주며, 같은 블록의 decimate 가 돌려준 수와 같습니다.
+  //
+  // 0 을 끼워 넣은 2배 레이트 신호를 필터링한 값입니다. 새 샘플이 들어오는
+  // 위상은 탭 쌍(게인 2)을, 다른 위상은 가운데 탭(0.5 x 2)만 씁니다.
+  int interpolate(const float *const *input, float *const *output,
+                  int numChannels, int numSamples) {
+    const int first = 1 - interpolatorPhase;
+    const int numInput = countPhase(numSamples, first);
+    const int numHeld = numSamples - numInput;
+    float *sums = interpolatorSums.getWritePointer(0);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      float *z = interpolatorState.getWritePointer(ch);
+      float *y = output[ch];
+      juce::FloatVectorOperations::copy(z + centre, input[ch], numInput);
+
+      // 새 입력 q 는 z[centre + q] 이고, 출력 first + 2q 에서 쓰입니다.
+      kernel(z, 0.0f, z + centre, z, interpolatorTaps.data(), sums, numInput);
+
+      for (int q = 0; q < numInput; ++q)
+        y[first + 2 * q] = sums[q];
+
+      // 나머지 위상은 그때까지 들어온 가장 최근 입력에서 (centre - 1) / 2
+      // 만큼 과거의 값입니다. first 가 0 이면 출력 2r + 1 앞에 r + 1 개,
+      // 1 이면 출력 2r 앞에 r 개가 들어와 있습니다.
+      const float *held = z + centre - 1 + (1 - first) - (centre - 1) / 2;
+      for (int r = 0; r < numHeld; ++r)
+        y[1 - first + 2 * r] = held[r];
+
+      std::memmove(z, z + numInput, sizeof(float) * (size_t)centre);
+    }
+
+    interpolatorPhase = (interpolatorPhase + numSamples) & 1;
+    return numInput;
+  }
+
+  // 레이트를 바꾸지 않고 같은 하프밴드로 거릅니다 (input 과 output 은 같아도
+  // 됩니다). 통과 대역은 나이퀴스트의 절반 아래이고, x - filter(x) 를 지연
+  // 맞춰 빼면 정확히 상보인 위쪽 대역이 됩니다.
+  void filter(const float *const *input, float *const *output, int numChannels,
+              int numSamples) {
+    const int history = length - 1;
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      float *x = filterState.getWritePointer(ch);
+      float *y = output[ch];
+      juce::FloatVectorOperations::copy(x + history, input[ch], numSamples);
+
+      filterKernel(x + centre, 0.5f, x + history, x, pairTaps.data(), y,
+                   numSamples);
+
+      std::memmove(x, x + numSamples, sizeof(float) * (size_t)history);
+    }
+  }
+
+private:
+  static constexpr int maxPairs = 16;
+
+  // y[i] = centreGain * centreRow[i]
+  //        + sum_j taps[j] * (newest[i - step * j] + oldest[i + step * j])
+  // 탭 쌍 수와 간격(데시메이터와 보간기는 한 줄 안에서 1, 같은 레이트
+  // filter 는 2)이 컴파일 상수면 탭 루프가 펼쳐지고 출력 루프가 벡터화되어
+  // 출력마다 레지스터에서 누산합니다.
+  using Kernel = void (*)(const float *centreRow, float centreGain,
+                          const float *newest, const float *oldest,
+                          const float *taps, float *y, int numSamples);
+
+  template <int NumPairs, int Step>
+  static void convolvePairs(const float *centreRow, float centreGain,
+                            const float *newest, const float *oldest,
+                            const float *taps, float *y, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+      float sum = centreGain * centreRow[i];
+      for (int j = 0; j < NumPairs; ++j)
+        sum += taps[j] * (newest[i - Step * j] + oldest[i + Step * j]);
+      y[i] = sum;
+    }
+  }
+
+  // 탭 쌍 수마다 펼친 커널 (1..maxPairs)
+  template <int Step, size_t... Pairs>
+  static constexpr std::array<Kernel, sizeof...(Pairs)>
+  makeKernels(std::index_sequence<Pairs...>) {
+    return {&convolvePairs<(int)Pairs + 1, Step>...};
+  }
+
+  template <int Step> static Kernel selectKernel(int pairs) {
+    static constexpr auto kernels =
+        makeKernels<Step>(std::make_index_sequence<(size_t)maxPairs>());
+    return kernels[(size_t)juce::jlimit(1, maxPairs, pairs) - 1];
+  }
+
+  // numSamples 개 중 first, first + 2, ... 위치에 있는 샘플 수
+  static int countPhase(int numSamples, int first) {
+    return numSamples > first ? (numSamples - first + 1) / 2 : 0;
+  }
+
+  int length = 3;
+  int centre = 1;
+  int numPairs = 1;
+  std::array<float, maxPairs> pairTaps{};
+  std::array<float, maxPairs> interpolatorTaps{}; // 게인 2 를 미리 곱한 탭
+  Kernel kernel = &convolvePairs<1, 1>;
+  Kernel filterKernel = &convolvePairs<1, 2>;
+
+  int oddHistory = 1;
+  int evenHistory = 1;
+  juce::AudioBuffer<float> oddState;
+  juce::AudioBuffer<float> evenState;
+  juce::AudioBuffer<float> interpolatorState;
+  juce::AudioBuffer<float> interpolatorSums;
+  juce::AudioBuffer<float> filterState;
+  int decimatorPhase = 0;
+  int interpolatorPhase = 0;
+};
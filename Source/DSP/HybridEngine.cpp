@@ -0,0 +1,170 @@
+#include "HybridEngine.h"
+
+HybridEngine::HybridEngine(PitchEngine &monophonicEngine,
+                           PitchEngine &polyphonicEngine)
+    : engines{&monophonicEngine, &polyphonicEngine},
+      active(&monophonicEngine) {}
+
+HybridEngine::~HybridEngine() {}
+
+void HybridEngine::prepare(double sr, int samplesPerBlock, int numChannels) {
+  sampleRate = sr;
+  holdSamples = (int)std::ceil(sampleRate * holdSeconds);
+  fadeLength = juce::jmax(1, (int)std::ceil(sampleRate * fadeSeconds));
+  scratch.setSize(juce::jmax(1, numChannels), juce::jmax(1, samplesPerBlock));
+
+  // 정렬 지연은 두 엔진 레이턴시의 차이로, 최대 레이턴시를 넘지 않습니다.
+  for (auto &delay : alignment)
+    delay.setSize(scratch.getNumChannels(),
+                  getMaxLatencySamples() + scratch.getNumSamples(), 1);
+
+  reset();
+}
+
+void HybridEngine::reset() {
+  active = engines[0];
+  target = nullptr;
+  stage = Stage::steady;
+  candidate = 0;
+  candidateSamples = 0;
+  active->reset();
+  pitch.finish();
+
+  for (auto &delay : alignment)
+    delay.clear();
+}
+
+void HybridEngine::setPitch(float semitones, int rampSamples) {
+  pitch.setTarget(semitones, rampSamples);
+
+  for (auto *engine : engines)
+    engine->setPitch(semitones, rampSamples);
+}
+
+void HybridEngine::setPeriodicity(float clarity) { periodicity = clarity; }
+
+int HybridEngine::classify(const juce::AudioBuffer<float> &buffer) const {
+  const int current = active == engines[1] ? 1 : 0;
+
+  // 무음에서는 주기성이 0이 되므로 판단을 보류합니다.
+  if (buffer.getMagnitude(0, buffer.getNumSamples()) < silenceLevel)
+    return current;
+
+  if (periodicity >= monophonicPeriodicity)
+    return 0;
+
+  if (periodicity < polyphonicPeriodicity)
+    return 1;
+
+  return current;
+}
+
+void HybridEngine::process(juce::AudioBuffer<float> &buffer) {
+  const int numChannels =
+      juce::jmin(buffer.getNumChannels(), scratch.getNumChannels());
+  const int numSamples = buffer.getNumSamples();
+
+  if (stage == Stage::steady) {
+    const int wanted = classify(buffer);
+
+    if (engines[(size_t)wanted] == active) {
+      candidateSamples = 0;
+    } else {
+      candidateSamples = wanted == candidate ? candidateSamples + numSamples
+                                             : numSamples;
+      candidate = wanted;
+
+      // 분류가 충분히 유지되면 새 엔진을 비우고 레이턴시만큼 미리 채웁니다.
+      if (candidateSamples >= holdSamples) {
+        target = engines[(size_t)wanted];
+        target->reset();
+        alignment[(size_t)wanted].clear();
+
+        // 쉬던 엔진의 음정 램프는 멈춰 있었으므로 지금 값에서 이어 갑니다.
+        target->setPitch(pitch.getCurrentValue(), 0);
+        target->setPitch(pitch.getTargetValue(), pitch.getRemainingSamples());
+        warmupRemaining = getLatencySamples();
+        fadePosition = 0;
+        stage = Stage::warming;
+        candidateSamples = 0;
+      }
+    }
+  }
+
+  pitch.skip(numSamples);
+
+  // 정렬 딜레이와 입력 사본은 prepare 에서 잡은 크기이므로 호스트가 그보다
+  // 큰 블록을 주면 그 크기 단위로 나눠 처리합니다. 전환 중에는 입력 사본을
+  // 들어오는 엔진에 흘립니다.
+  for (int offset = 0; offset < numSamples;) {
+    const int n = juce::jmin(numSamples - offset, scratch.getNumSamples());
+    juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(),
+                                   buffer.getNumChannels(), offset, n);
+
+    if (stage == Stage::steady) {
+      active->process(chunk);
+      alignOutput(indexOf(active), chunk, numChannels);
+    } else {
+      processTransition(chunk, numChannels);
+    }
+
+    offset += n;
+  }
+}
+
+void HybridEngine::alignOutput(int engine, juce::AudioBuffer<float> &buffer,
+                               int numChannels) {
+  const int delay = getAlignmentDelay(engine);
+  if (delay == 0)
+    return;
+
+  auto &ring = alignment[(size_t)engine];
+
+  for (int ch = 0; ch < numChannels; ++ch) {
+    float *data = buffer.getWritePointer(ch);
+    ring.delayBlock(ch, data, data, buffer.getNumSamples(), delay);
+  }
+
+  ring.advance(buffer.getNumSamples());
+}
+
+void HybridEngine::processTransition(juce::AudioBuffer<float> &buffer,
+                                     int numChannels) {
+  const int numSamples = buffer.getNumSamples();
+  juce::AudioBuffer<float> incoming(scratch.getArrayOfWritePointers(),
+                                    scratch.getNumChannels(), numSamples);
+
+  for (int ch = 0; ch < numChannels; ++ch)
+    incoming.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+
+  active->process(buffer);
+  target->process(incoming);
+
+  // 들어오는 엔진의 정렬 딜레이도 채워 두어야 페이드 시작부터 맞습니다.
+  alignOutput(indexOf(active), buffer, numChannels);
+  alignOutput(indexOf(target), incoming, numChannels);
+
+  if (stage == Stage::warming) {
+    warmupRemaining -= numSamples;
+    if (warmupRemaining <= 0)
+      stage = Stage::fading;
+    return;
+  }
+
+  // 청크 단위 선형 램프로 두 엔진 출력을 섞습니다.
+  const float startGain = (float)fadePosition / (float)fadeLength;
+  fadePosition = juce::jmin(fadeLength, fadePosition + numSamples);
+  const float endGain = (float)fadePosition / (float)fadeLength;
+
+  for (int ch = 0; ch < numChannels; ++ch) {
+    buffer.applyGainRamp(ch, 0, numSamples, 1.0f - startGain, 1.0f - endGain);
+    buffer.addFromWithRamp(ch, 0, incoming.getReadPointer(ch), numSamples,
+                           startGain, endGain);
+  }
+
+  if (fadePosition >= fadeLength) {
+    active = target;
+    target = nullptr;
+    stage = Stage::steady;
+  }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "PitchEngine.h"
+#include "PitchRamp.h"
+#include "RingBuffer.h"
+#include <JuceHeader.h>
+
+// 자동 모노/폴리 전환 엔진.
+// 피치 검출기의 첫 NSDF 최댓값(주기성)으로 블록마다 입력을 단음/화음으로 분류해
+// 단음이면 시간 영역 엔진, 화음이면 스펙트럼 엔진을 씁니다.
+// 전환할 때만 새 엔진을 레이턴시만큼 미리 돌려 채운 뒤 두 출력을
+// 크로스페이드하고, 페이드가 끝나면 이전 엔진은 더 이상 돌리지 않습니다.
+// 레이턴시가 짧은 엔진의 출력은 긴 쪽에 맞춰 지연시키므로, 전환해도
+// 호스트에 보고하는 레이턴시와 원음 정렬이 그대로입니다.
+//
+// 두 엔진은 소유하지 않으며, prepare 도 소유자가 따로 (이 엔진보다 먼저)
+// 호출해야 합니다.
+class HybridEngine : public PitchEngine {
+public:
+  HybridEngine(PitchEngine &monophonicEngine, PitchEngine &polyphonicEngine);
+  ~HybridEngine() override;
+
+  void prepare(double sampleRate, int samplesPerBlock,
+               int numChannels) override;
+  void reset() override;
+  using PitchEngine::setPitch;
+  void setPitch(float semitones, int rampSamples) override;
+  void process(juce::AudioBuffer<float> &buffer) override;
+
+  // 입력의 주기성 (0..1, PitchDetector::getClarity). 블록마다 process 전에
+  // 넘겨 줍니다.
+  void setPeriodicity(float clarity);
+
+  // 두 엔진 중 긴 쪽 레이턴시 (어느 엔진이 돌든 같습니다)
+  int getLatencySamples() const override {
+    return juce::jmax(engines[0]->getLatencySamples(),
+                      engines[1]->getLatencySamples());
+  }
+
+  int getMaxLatencySamples() const override {
+    return juce::jmax(engines[0]->getMaxLatencySamples(),
+                      engines[1]->getMaxLatencySamples());
+  }
+
+  int getTailSamples() const override {
+    return juce::jmax(engines[0]->getTailSamples() + getAlignmentDelay(0),
+                      engines[1]->getTailSamples() + getAlignmentDelay(1));
+  }
+
+  bool isPolyphonic() const { return active == engines[1]; }
+
+private:
+  enum class Stage { steady, warming, fading };
+
+  int classify(const juce::AudioBuffer<float> &buffer) const;
+  void processTransition(juce::AudioBuffer<float> &buffer, int numChannels);
+
+  // engine 출력을 긴 쪽 레이턴시에 맞추는 지연과, 그 지연을 거는 함수
+  int getAlignmentDelay(int engine) const {
+    return getLatencySamples() - engines[(size_t)engine]->getLatencySamples();
+  }
+  int indexOf(const PitchEngine *engine) const {
+    return engine == engines[1] ? 1 : 0;
+  }
+  void alignOutput(int engine, juce::AudioBuffer<float> &buffer,
+                   int numChannels);
+
+  std::array<PitchEngine *, 2> engines;
+  PitchEngine *active = nullptr;
+  PitchEngine *target = nullptr;
+
+  double sampleRate = 44100.0;
+  float periodicity = 0.0f;
+
+  // 쉬는 엔진이 전환 때 이어 받을 음정 램프 (process 마다 같이 진행)
+  PitchRamp pitch;
+
+  // 분류가 holdSeconds 동안 유지되어야 전환을 시작합니다.
+  int candidate = 0;
+  int candidateSamples = 0;
+  int holdSamples = 0;
+  static constexpr double holdSeconds = 0.15;
+
+  Stage stage = Stage::steady;
+  int warmupRemaining = 0;
+  int fadePosition = 0;
+  int fadeLength = 0;
+  static constexpr double fadeSeconds = 0.05;
+
+  // 분류 임계값 (히스테리시스) 과 무음 판정 레벨
+  static constexpr float monophonicPeriodicity = 0.85f;
+  static constexpr float polyphonicPeriodicity = 0.7f;
+  static constexpr float silenceLevel = 1.0e-3f;
+
+  // 들어오는 엔진용 입력 사본 (prepare 에서 블록 크기만큼 할당)
+  juce::AudioBuffer<float> scratch;
+
+  // 엔진별 출력 정렬 딜레이 (두 엔진의 최대 레이턴시 + 블록 크기)
+  std::array<RingBuffer, 2> alignment;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HybridEngine)
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "SimdLanes.h"
+#include <JuceHeader.h>
+
+// 히스토리 버퍼 분수 지연 읽기용 보간 커널.
+//
+// 모든 커널은 같은 형태를 가집니다:
+//   numTaps  - 읽는 연속 샘플 수
+//   firstTap - 기준 샘플 i0 이전에 필요한 샘플 수 (x[firstTap] == i0)
+//   interpolate(x, t) - 탭 레인 x[0..numTaps) 와 비율 t(0..1] 로 i0 + t 위치 값
+// 레인은 연속된 출력 샘플이므로 가중치 계산과 누산이 그대로 SIMD가 됩니다.
+enum class InterpolationQuality { linear, hermite, lagrange4, lagrange6, sinc };
+constexpr int numInterpolationQualities = 5;
+
+namespace Interpolators {
+using SimdLanes::Lanes;
+
+// 어떤 커널을 골라도 히스토리 읽기 범위가 같도록 하는 공통 여유분.
+// 읽기 인덱스는 i0 - maxFirstTap 에서 시작하고, 모든 헤드의 딜레이에
+// maxLookahead 를 더해 가장 긴 커널도 아직 쓰이지 않은 샘플을 읽지 않습니다.
+constexpr int maxFirstTap = 3;
+constexpr int maxLookahead = 3;
+
+struct Linear {
+  static constexpr int numTaps = 2;
+  static constexpr int firstTap = 0;
+
+  static Lanes interpolate(const Lanes *x, const float *tRamp) {
+    const auto t = SimdLanes::load(tRamp);
+    return x[0] + t * (x[1] - x[0]);
+  }
+};
+
+// 4점 3차 에르미트 (Catmull-Rom)
+struct Hermite {
+  static constexpr int numTaps = 4;
+  static constexpr int firstTap = 1;
+
+  static Lanes interpolate(const Lanes *x, const float *tRamp) {
+    const auto t = SimdLanes::load(tRamp);
+    const auto c1 = (x[2] - x[0]) * 0.5f;
+    const auto c2 = x[0] - x[1] * 2.5f + x[2] * 2.0f - x[3] * 0.5f;
+    const auto c3 = (x[3] - x[0]) * 0.5f + (x[1] - x[2]) * 1.5f;
+    return ((c3 * t + c2) * t + c1) * t + x[1];
+  }
+};
+
+// N점 라그랑주. 노드는 i0 기준 -(N/2 - 1) .. N/2 입니다.
+template <int N> struct Lagrange {
+  static constexpr int numTaps = N;
+  static constexpr int firstTap = N / 2 - 1;
+
+  static Lanes interpolate(const Lanes *x, const float *tRamp) {
+    const auto t = SimdLanes::load(tRamp);
+    auto sum = SimdLanes::expand(0.0f);
+
+    for (int j = 0; j < N; ++j) {
+      auto weight = SimdLanes::expand(1.0f);
+
+      for (int m = 0; m < N; ++m)
+        if (m != j)
+          weight = weight * ((t - (float)(m - firstTap)) * (1.0f / (float)(j - m)));
+
+      sum += x[j] * weight;
+    }
+
+    return sum;
+  }
+};
+
+// 카이저 윈도우 sinc 폴리페이즈 뱅크 (8탭, 512 위상)
+// 위상 행은 인스턴스 간에 공유되는 정적 테이블로 한 번만 계산됩니다.
+struct Sinc {
+  static constexpr int numTaps = 8;
+  static constexpr int firstTap = 3;
+  static constexpr int numPhases = 512;
+
+  struct Table {
+    Table() {
+      constexpr double cutoff = 0.9; // 나이퀴스트 대비 통과 대역
+      constexpr double beta = 7.0;
+      const double halfLength = numTaps / 2;
+      const double norm = juce::dsp::SpecialFunctions::besselI0(beta);
+
+      // t == 1.0 까지 포함하도록 numPhases + 1 행을 둡니다.
+      for (int row = 0; row <= numPhases; ++row) {
+        const double t = (double)row / numPhases;
+        auto *coeffs = rows[(size_t)row].data();
+        double sum = 0.0;
+
+        for (int j = 0; j < numTaps; ++j) {
+          const double d = (double)(j - firstTap) - t;
+          const double r = d / halfLength;
+          const double window =
+              std::abs(r) < 1.0
+                  ? juce::dsp::SpecialFunctions::besselI0(
+                        beta * std::sqrt(1.0 - r * r)) /
+                        norm
+                  : 0.0;
+          const double arg = juce::MathConstants<double>::pi * cutoff * d;
+          const double sinc =
+              juce::exactlyEqual(d, 0.0) ? 1.0 : std::sin(arg) / arg;
+
+          coeffs[j] = (float)(cutoff * sinc * window);
+          sum += coeffs[j];
+        }
+
+        // DC 이득을 1로 맞춥니다.
+        for (int j = 0; j < numTaps; ++j)
+          coeffs[j] = (float)(coeffs[j] / sum);
+      }
+    }
+
+    std::array<std::array<float, numTaps>, numPhases + 1> rows;
+  };
+
+  static const Table &getTable() {
+    static const Table table;
+    return table;
+  }
+
+  static Lanes interpolate(const Lanes *x, const float *tRamp) {
+    const auto &table = getTable();
+
+    // 레인마다 가장 가까운 위상 행을 모아 탭별 가중치 레인을 만듭니다.
+    alignas(SimdLanes::alignment) float weights[numTaps][SimdLanes::width];
+
+    for (int k = 0; k < SimdLanes::width; ++k) {
+      const auto &row =
+          table.rows[(size_t)(int)(tRamp[k] * (float)numPhases + 0.5f)];
+
+      for (int j = 0; j < numTaps; ++j)
+        weights[j][k] = row[(size_t)j];
+    }
+
+    auto sum = SimdLanes::expand(0.0f);
+
+    for (int j = 0; j < numTaps; ++j)
+      sum += x[j] * SimdLanes::load(weights[j]);
+
+    return sum;
+  }
+};
+} // namespace Interpolators
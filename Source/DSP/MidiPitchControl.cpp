@@ -0,0 +1,195 @@
+#include "MidiPitchControl.h"
+
+void MidiPitchControl::prepare(double sr) {
+  sampleRate = sr;
+  reset();
+}
+
+void MidiPitchControl::reset() {
+  numHeld = 0;
+  updateExpression();
+  ramp.setTarget(getBase(), 0);
+}
+
+void MidiPitchControl::setRootNote(int noteNumber) {
+  rootNote = juce::jlimit(0, 127, noteNumber);
+}
+
+void MidiPitchControl::setGlideTime(float milliseconds) {
+  glideMs = juce::jmax(0.0f, milliseconds);
+}
+
+void MidiPitchControl::setLegato(bool shouldGlideOnlyWhenLegato) {
+  legato = shouldGlideOnlyWhenLegato;
+}
+
+void MidiPitchControl::setNoteControl(bool shouldFollowNotes) {
+  if (noteControl == shouldFollowNotes)
+    return;
+
+  noteControl = shouldFollowNotes;
+
+  if (!noteControl) {
+    numHeld = 0;
+    updateTarget(false);
+  }
+}
+
+void MidiPitchControl::setExpressionSource(ExpressionSource source) {
+  if (expressionSource == source)
+    return;
+
+  // 페달을 켜거나 끄면 노브와 마지막 페달 위치 사이를 스무딩 시간 동안
+  // 옮깁니다.
+  expressionSource = source;
+  updateExpression();
+}
+
+void MidiPitchControl::setExpressionController(int controllerNumber) {
+  expressionController = juce::jlimit(0, 127, controllerNumber);
+}
+
+void MidiPitchControl::setExpressionCurve(ExpressionCurve curve) {
+  if (expressionCurve == curve)
+    return;
+
+  expressionCurve = curve;
+  updateExpression();
+}
+
+void MidiPitchControl::setExpressionRange(float heelSemitones,
+                                          float toeSemitones) {
+  heelSemitones = juce::jlimit(-maxInterval, maxInterval, heelSemitones);
+  toeSemitones = juce::jlimit(-maxInterval, maxInterval, toeSemitones);
+
+  if (juce::exactlyEqual(heel, heelSemitones) &&
+      juce::exactlyEqual(toe, toeSemitones))
+    return;
+
+  heel = heelSemitones;
+  toe = toeSemitones;
+  updateExpression();
+}
+
+void MidiPitchControl::setFallback(float semitones) {
+  if (juce::exactlyEqual(fallback, semitones))
+    return;
+
+  fallback = semitones;
+  followBase();
+}
+
+void MidiPitchControl::handleMessage(const juce::MidiMessage &message) {
+  if (expressionSource == ExpressionSource::controller &&
+      message.isControllerOfType(expressionController)) {
+    expressionValue = (float)message.getControllerValue() / 127.0f;
+    updateExpression();
+    return;
+  }
+
+  if (expressionSource == ExpressionSource::pitchBend &&
+      message.isPitchWheel()) {
+    expressionValue = (float)message.getPitchWheelValue() / 16383.0f;
+    updateExpression();
+    return;
+  }
+
+  if (!noteControl)
+    return;
+
+  if (message.isNoteOn())
+    noteOn(message.getNoteNumber());
+  else if (message.isNoteOff())
+    noteOff(message.getNoteNumber());
+  else if (message.isAllNotesOff() || message.isAllSoundOff()) {
+    numHeld = 0;
+    updateTarget(false);
+  }
+}
+
+void MidiPitchControl::noteOn(int noteNumber) {
+  const bool wasHolding = numHeld > 0;
+
+  // 같은 노트가 이미 있으면 빼고 맨 뒤(가장 최근)에 다시 넣습니다.
+  auto *end = heldNotes.data() + numHeld;
+  numHeld = (int)(std::remove(heldNotes.data(), end, noteNumber) -
+                  heldNotes.data());
+
+  if (numHeld == maxHeldNotes) {
+    std::copy(heldNotes.begin() + 1, heldNotes.end(), heldNotes.begin());
+    --numHeld;
+  }
+
+  heldNotes[(size_t)numHeld++] = noteNumber;
+  updateTarget(wasHolding);
+}
+
+void MidiPitchControl::noteOff(int noteNumber) {
+  auto *end = heldNotes.data() + numHeld;
+  numHeld = (int)(std::remove(heldNotes.data(), end, noteNumber) -
+                  heldNotes.data());
+
+  // 남은 노트로 돌아갈 때는 레가토 전환으로 봅니다.
+  updateTarget(numHeld > 0);
+}
+
+void MidiPitchControl::updateTarget(bool wasHolding) {
+  const float newTarget =
+      numHeld > 0 ? juce::jlimit(-maxInterval, maxInterval,
+                                 (float)(heldNotes[(size_t)(numHeld - 1)] -
+                                         rootNote))
+                  : getBase();
+
+  if (juce::exactlyEqual(newTarget, ramp.getTargetValue()))
+    return;
+
+  // 글라이드가 없으면 노트 시점에서 바로 바뀝니다.
+  const int glideSamples = (int)std::round(sampleRate * glideMs / 1000.0);
+  const bool glide = glideSamples > 0 && (wasHolding || !legato);
+  ramp.setTarget(newTarget, glide ? glideSamples : 0);
+}
+
+void MidiPitchControl::updateExpression() {
+  const float x = expressionValue;
+  float shaped = x;
+
+  switch (expressionCurve) {
+  case ExpressionCurve::linear:
+    break;
+  case ExpressionCurve::exponential:
+    shaped = x * x;
+    break;
+  case ExpressionCurve::logarithmic:
+    shaped = std::sqrt(x);
+    break;
+  case ExpressionCurve::sCurve:
+    shaped = x * x * (3.0f - 2.0f * x);
+    break;
+  }
+
+  expression = heel + (toe - heel) * shaped;
+  followBase();
+}
+
+float MidiPitchControl::getBase() const {
+  return expressionSource != ExpressionSource::off ? expression : fallback;
+}
+
+int MidiPitchControl::getSmoothingSamples() const {
+  return (int)std::round(sampleRate * smoothingSeconds);
+}
+
+void MidiPitchControl::followBase() {
+  if (numHeld > 0)
+    return;
+
+  const float base = getBase();
+  if (juce::exactlyEqual(base, ramp.getTargetValue()))
+    return;
+
+  // 노트가 없으면 노브나 페달을 따릅니다. 노트를 뗀 뒤 돌아가는 글라이드
+  // 중이면 남은 시간 안에 새 값에 닿고, 아니면 스무딩 시간 동안 옮깁니다
+  // (노브와 페달 자체의 움직임은 글라이드하지 않음).
+  ramp.setTarget(base,
+                 juce::jmax(ramp.getRemainingSamples(), getSmoothingSamples()));
+}
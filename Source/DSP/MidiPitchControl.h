@@ -0,0 +1,84 @@
+#pragma once
+
+#include "PitchRamp.h"
+#include <JuceHeader.h>
+
+// MIDI 노트로 피치 시프트 음정을 정합니다.
+// 눌린 노트 중 가장 최근 노트와 루트 노트의 차이(반음)가 목표 음정이 되고,
+// 모든 노트를 떼면 노브 음정(fallback)으로 돌아갑니다.
+// 글라이드는 반음 단위 선형 램프이며, 레가토 모드에서는 노트를 누른 채
+// 다른 노트로 넘어갈 때만 글라이드합니다.
+//
+// 익스프레션 페달(CC 또는 피치 벤드)을 켜면 노트가 없을 때의 음정이
+// 노브 대신 페달 값이 됩니다. 페달 값(0..1)은 응답 곡선을 거쳐 힐(0)과
+// 토(1) 음정 사이로 매핑됩니다.
+//
+// 결과는 (목표, 램프 길이) 로만 정합니다. 노트는 글라이드 시간(없으면 즉시),
+// 노브와 페달은 7비트 CC 나 자동화의 계단이 들리지 않도록 smoothingSeconds
+// 동안 램프합니다. 프로세서는 블록을 MIDI 이벤트 시점에서 나누고 이 램프를
+// 엔진에 넘기며, 샘플 단위 스무딩은 엔진이 같은 램프로 한 번만 합니다.
+class MidiPitchControl {
+public:
+  enum class ExpressionSource { off, controller, pitchBend };
+  enum class ExpressionCurve { linear, exponential, logarithmic, sCurve };
+
+  void prepare(double sampleRate);
+  void reset();
+
+  void setRootNote(int noteNumber);
+  void setGlideTime(float milliseconds);
+  void setLegato(bool shouldGlideOnlyWhenLegato);
+
+  // 꺼져 있으면 노트 메시지를 무시하고 눌린 노트를 모두 놓습니다.
+  void setNoteControl(bool shouldFollowNotes);
+
+  void setExpressionSource(ExpressionSource source);
+  void setExpressionController(int controllerNumber);
+  void setExpressionCurve(ExpressionCurve curve);
+  void setExpressionRange(float heelSemitones, float toeSemitones);
+
+  // 노트가 없을 때의 음정 (PITCH 파라미터). 블록마다 넘겨 줍니다.
+  void setFallback(float semitones);
+
+  void handleMessage(const juce::MidiMessage &message);
+
+  // 엔진이 따라갈 음정 램프. 엔진과 같은 샘플 수만큼 advance 합니다.
+  const PitchRamp &getRamp() const { return ramp; }
+  void advance(int numSamples) { ramp.skip(numSamples); }
+
+  static constexpr float maxInterval = 24.0f;
+
+private:
+  void noteOn(int noteNumber);
+  void noteOff(int noteNumber);
+  void updateTarget(bool wasHolding);
+  void updateExpression();
+  void followBase();
+
+  // 노트가 없을 때 따라가는 음정: 페달이 켜져 있으면 페달, 아니면 노브
+  float getBase() const;
+  int getSmoothingSamples() const;
+
+  double sampleRate = 44100.0;
+  int rootNote = 60;
+  float glideMs = 0.0f;
+  bool legato = true;
+  float fallback = 0.0f;
+  bool noteControl = true;
+
+  ExpressionSource expressionSource = ExpressionSource::off;
+  int expressionController = 11;
+  ExpressionCurve expressionCurve = ExpressionCurve::linear;
+  float heel = 0.0f;
+  float toe = 12.0f;
+  float expressionValue = 0.0f; // 마지막으로 받은 페달 위치 (0..1)
+  float expression = 0.0f;      // 곡선과 범위를 거친 페달 음정
+  static constexpr double smoothingSeconds = 0.02;
+
+  // 눌린 노트 (오래된 순). 가득 차면 가장 오래된 노트를 버립니다.
+  static constexpr int maxHeldNotes = 16;
+  std::array<int, maxHeldNotes> heldNotes{};
+  int numHeld = 0;
+
+  PitchRamp ramp;
+};
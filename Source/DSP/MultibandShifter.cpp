@@ -0,0 +1,335 @@
+#include "MultibandShifter.h"
+
+MultibandShifter::MultibandShifter() {}
+
+MultibandShifter::~MultibandShifter() {}
+
+void MultibandShifter::prepare(double sr, int samplesPerBlock,
+                               int numChannels) {
+  sampleRate = sr;
+  maxBlockSize = juce::jmax(1, samplesPerBlock);
+  numChannels = juce::jlimit(1, 2, numChannels);
+
+  // 크로스오버가 레벨 레이트의 1/4 에 가장 가까운 레벨을 고릅니다.
+  auto splitLevelFor = [this](double crossover) {
+    return (int)std::lround(std::log2(sampleRate / (4.0 * crossover)));
+  };
+  highSplitLevel =
+      juce::jlimit(1, maxLevels - 2, splitLevelFor(highCrossover));
+  lowSplitLevel = juce::jlimit(highSplitLevel + 2, maxLevels,
+                               splitLevelFor(lowCrossover));
+  midLevel = highSplitLevel - 1;
+  lowLevel = lowSplitLevel - 2;
+
+  // 레벨마다 레이트가 반이 되고, 홀수 블록이면 한 샘플이 더 나올 수 있습니다.
+  std::array<int, maxLevels + 1> sizes{};
+  sizes[0] = maxBlockSize;
+  for (int k = 0; k < lowSplitLevel; ++k)
+    sizes[(size_t)k + 1] = sizes[(size_t)k] / 2 + 1;
+
+  // 한 레벨의 필터는 모두 같은 스펙이어야 피치 0 에서 대역 합이 입력의
+  // 정확한 지연이 됩니다 (분할 때 올린 경로와 합칠 때 올린 경로가 같음).
+  auto prepareHalfband = [&](HalfbandFilter &filter, int level) {
+    filter.prepare(numChannels, sizes[(size_t)level], halfbandTransition,
+                   halfbandStopbandDb);
+  };
+
+  for (int k = 0; k < lowSplitLevel; ++k) {
+    prepareHalfband(analysis[(size_t)k], k);
+    levels[(size_t)k + 1].setSize(numChannels, sizes[(size_t)k + 1]);
+  }
+
+  for (int k = highSplitLevel; k < lowSplitLevel; ++k)
+    roundTrip[(size_t)k].setSize(numChannels, sizes[(size_t)k]);
+
+  for (int k = 0; k < lowLevel; ++k) {
+    prepareHalfband(synthesis[(size_t)k], k);
+    raised[(size_t)k].setSize(numChannels, sizes[(size_t)k]);
+  }
+
+  prepareHalfband(midInterpolator, midLevel);
+  prepareHalfband(highSplit, highSplitLevel);
+  prepareHalfband(lowSplit, lowSplitLevel);
+
+  for (int band = 0; band < numBands; ++band) {
+    const int level = getBandLevel(band);
+    auto &shifter = shifters[(size_t)band];
+
+    // 하모니 보이스는 단일 대역 그레인 엔진에서만 쓰므로 대역 시프터에는
+    // 보이스 램프 행을 잡지 않습니다.
+    shifter.setHarmonyCapacity(0);
+    shifter.setGrainLengthLimit(bandGrainMs[(size_t)band]);
+    shifter.setGrainLength(bandGrainMs[(size_t)band]);
+    shifter.prepare(sampleRate / (1 << level), sizes[(size_t)level],
+                    numChannels);
+
+    bandBuffers[(size_t)band].setSize(numChannels, sizes[(size_t)level]);
+  }
+
+  highComplementDelay = raiseLatency(highSplit.getFilterLatencySamples(),
+                                     highSplitLevel, 0, false);
+  midComplementDelay = raiseLatency(lowSplit.getFilterLatencySamples(),
+                                    lowSplitLevel, highSplitLevel, false);
+  highComplement.setSize(numChannels, highComplementDelay + sizes[0], 1);
+  midComplement.setSize(numChannels,
+                        midComplementDelay + sizes[(size_t)highSplitLevel], 1);
+
+  // 중역과 저역은 중역 레벨에서, 그 합과 고역은 원래 레이트에서 만납니다.
+  // 두 경로는 중역 레벨 위로 같은 보간기를 거치므로 차이는 중역 레벨
+  // 샘플의 정수배입니다.
+  const int midScale = 1 << midLevel;
+  const int lowScale = 1 << lowLevel;
+  const int lowLead =
+      getBandLatency(low, false) - getBandLatency(mid, false);
+
+  alignmentDelay.fill(0);
+  if (lowLead >= 0) {
+    alignmentDelay[mid] = lowLead / midScale;
+  } else {
+    alignmentDelay[low] = (-lowLead + lowScale - 1) / lowScale;
+    alignmentDelay[mid] = (lowLead + alignmentDelay[low] * lowScale) / midScale;
+  }
+
+  // 고역은 그레인이 가장 짧아 항상 먼저 도착합니다.
+  latency = getBandLatency(mid, false) + alignmentDelay[mid] * midScale;
+  jassert(latency >= getBandLatency(high, false));
+  alignmentDelay[high] = juce::jmax(0, latency - getBandLatency(high, false));
+
+  tail = 0;
+  for (int band = 0; band < numBands; ++band) {
+    const int level = getBandLevel(band);
+    alignment[(size_t)band].setSize(
+        numChannels, alignmentDelay[(size_t)band] + sizes[(size_t)level], 1);
+    tail = juce::jmax(tail, getBandLatency(band, true) +
+                                (alignmentDelay[(size_t)band] << level));
+  }
+
+  reset();
+}
+
+void MultibandShifter::reset() {
+  for (auto &shifter : shifters)
+    shifter.reset();
+
+  for (auto &filter : analysis)
+    filter.reset();
+  for (auto &filter : synthesis)
+    filter.reset();
+
+  midInterpolator.reset();
+  highSplit.reset();
+  lowSplit.reset();
+
+  highComplement.clear();
+  midComplement.clear();
+
+  for (auto &delay : alignment)
+    delay.clear();
+}
+
+void MultibandShifter::setPitch(float semitones, int rampSamples) {
+  // 대역 시프터는 자기 레벨 레이트로 돌므로 램프 길이도 그 레이트로
+  // 환산합니다.
+  for (int band = 0; band < numBands; ++band) {
+    const int scale = 1 << getBandLevel(band);
+    shifters[(size_t)band].setPitch(semitones,
+                                    (rampSamples + scale / 2) / scale);
+  }
+}
+
+void MultibandShifter::setInterpolationQuality(InterpolationQuality quality) {
+  for (auto &shifter : shifters)
+    shifter.setInterpolationQuality(quality);
+}
+
+void MultibandShifter::setGrainHeads(int requestedHeads) {
+  for (auto &shifter : shifters)
+    shifter.setGrainHeads(requestedHeads);
+}
+
+void MultibandShifter::setWindowShape(WindowShape shape) {
+  for (auto &shifter : shifters)
+    shifter.setWindowShape(shape);
+}
+
+int MultibandShifter::raiseLatency(int inner, int from, int to,
+                                   bool spread) const {
+  // 레벨 k 의 데시메이터와 보간기 한 쌍은 레벨 k 샘플로 N - 1 만큼 늦추고,
+  // 응답은 그 두 배 길이에 걸칩니다. 안쪽 지연은 레벨마다 두 배가 됩니다.
+  for (int k = from - 1; k >= to; --k)
+    inner = (spread ? 2 : 1) * analysis[(size_t)k].getLatencySamples() +
+            2 * inner;
+
+  return inner;
+}
+
+int MultibandShifter::getBandLatency(int band, bool spread) const {
+  const auto &shifter = shifters[(size_t)band];
+  const int shifted =
+      spread ? shifter.getTailSamples() : shifter.getLatencySamples();
+
+  // 같은 레이트 크로스오버는 가운데 탭만큼 늦추고 길이 전체에 걸칩니다.
+  const int highSplitDelay =
+      (spread ? 2 : 1) * highSplit.getFilterLatencySamples();
+  const int lowSplitDelay =
+      (spread ? 2 : 1) * lowSplit.getFilterLatencySamples();
+
+  if (band == high)
+    return raiseLatency(highSplitDelay, highSplitLevel, 0, spread) + shifted;
+
+  if (band == mid) {
+    // 고역 크로스오버 레벨에서 아래 대역과, 되돌려 올린 저역의 차이입니다.
+    const int atSplit =
+        highSplitDelay +
+        raiseLatency(lowSplitDelay, lowSplitLevel, highSplitLevel, spread);
+    return raiseLatency(
+        raiseLatency(atSplit, highSplitLevel, midLevel, spread) + shifted,
+        midLevel, 0, spread);
+  }
+
+  const int atLowLevel =
+      raiseLatency(lowSplitDelay, lowSplitLevel, lowLevel, spread) + shifted;
+  return raiseLatency(highSplitDelay + raiseLatency(atLowLevel, lowLevel,
+                                                    highSplitLevel, spread),
+                      highSplitLevel, 0, spread);
+}
+
+void MultibandShifter::process(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  const int numChannels =
+      juce::jmin(buffer.getNumChannels(), bandBuffers[high].getNumChannels());
+  std::array<int, maxLevels + 1> counts{};
+
+  // 호스트가 prepare 보다 큰 블록을 주면 maxBlockSize 단위로 나눕니다.
+  for (int offset = 0; offset < numSamples; offset += maxBlockSize) {
+    const int n = juce::jmin(maxBlockSize, numSamples - offset);
+    juce::AudioBuffer<float> chunk(buffer.getArrayOfWritePointers(),
+                                   numChannels, offset, n);
+
+    counts[0] = n;
+    splitBands(chunk, numChannels, counts);
+
+    for (int band = 0; band < numBands; ++band) {
+      const int count = counts[(size_t)getBandLevel(band)];
+      auto view = makeView(bandBuffers[(size_t)band], numChannels, count);
+      shifters[(size_t)band].process(view);
+      delayBand(band, numChannels, count);
+    }
+
+    mergeBands(chunk, numChannels, counts);
+  }
+}
+
+void MultibandShifter::splitBands(const juce::AudioBuffer<float> &buffer,
+                                  int numChannels,
+                                  std::array<int, maxLevels + 1> &counts) {
+  // 저역 크로스오버 레벨까지 내려가며, 고역 크로스오버 레벨에서는 아래
+  // 대역만 남겨 계속 내립니다.
+  for (int k = 0; k < lowSplitLevel; ++k) {
+    auto &level = levels[(size_t)k];
+
+    if (k == highSplitLevel)
+      highSplit.filter(level.getArrayOfReadPointers(),
+                       level.getArrayOfWritePointers(), numChannels,
+                       counts[(size_t)k]);
+
+    counts[(size_t)k + 1] = analysis[(size_t)k].decimate(
+        k == 0 ? buffer.getArrayOfReadPointers()
+               : level.getArrayOfReadPointers(),
+        levels[(size_t)k + 1].getArrayOfWritePointers(), numChannels,
+        counts[(size_t)k]);
+  }
+
+  auto &lowSplitBuffer = levels[(size_t)lowSplitLevel];
+  lowSplit.filter(lowSplitBuffer.getArrayOfReadPointers(),
+                  lowSplitBuffer.getArrayOfWritePointers(), numChannels,
+                  counts[(size_t)lowSplitLevel]);
+
+  // 거른 저역을 고역 크로스오버 레벨까지 되돌려 올립니다. 저역 시프터는
+  // 그 사이 레벨에서 같은 신호를 받습니다.
+  for (int k = lowSplitLevel - 1; k >= highSplitLevel; --k) {
+    const auto &source = k + 1 == lowSplitLevel ? lowSplitBuffer
+                                                : roundTrip[(size_t)k + 1];
+    analysis[(size_t)k].interpolate(
+        source.getArrayOfReadPointers(),
+        roundTrip[(size_t)k].getArrayOfWritePointers(), numChannels,
+        counts[(size_t)k]);
+  }
+
+  for (int ch = 0; ch < numChannels; ++ch)
+    bandBuffers[low].copyFrom(ch, 0, roundTrip[(size_t)lowLevel], ch, 0,
+                              counts[(size_t)lowLevel]);
+
+  // 아래 대역을 원래 레이트로 올려 지연한 입력에서 빼면 고역입니다.
+  auto &split = levels[(size_t)highSplitLevel];
+
+  for (int k = highSplitLevel - 1; k >= 0; --k) {
+    const auto &source = k + 1 == highSplitLevel ? split : raised[(size_t)k + 1];
+    analysis[(size_t)k].interpolate(source.getArrayOfReadPointers(),
+                                    raised[(size_t)k].getArrayOfWritePointers(),
+                                    numChannels, counts[(size_t)k]);
+  }
+
+  for (int ch = 0; ch < numChannels; ++ch) {
+    float *highBand = bandBuffers[high].getWritePointer(ch);
+    highComplement.delayBlock(ch, buffer.getReadPointer(ch), highBand,
+                              counts[0], highComplementDelay);
+    juce::FloatVectorOperations::subtract(highBand, raised[0].getReadPointer(ch),
+                                          counts[0]);
+  }
+  highComplement.advance(counts[0]);
+
+  // 아래 대역을 되돌려 올린 저역만큼 늦춰 그 저역을 빼면 중역입니다.
+  const int numSplit = counts[(size_t)highSplitLevel];
+
+  for (int ch = 0; ch < numChannels; ++ch) {
+    float *data = split.getWritePointer(ch);
+    midComplement.delayBlock(ch, data, data, numSplit, midComplementDelay);
+    juce::FloatVectorOperations::subtract(
+        data, roundTrip[(size_t)highSplitLevel].getReadPointer(ch), numSplit);
+  }
+  midComplement.advance(numSplit);
+
+  midInterpolator.interpolate(split.getArrayOfReadPointers(),
+                              bandBuffers[mid].getArrayOfWritePointers(),
+                              numChannels, counts[(size_t)midLevel]);
+}
+
+void MultibandShifter::mergeBands(juce::AudioBuffer<float> &buffer,
+                                  int numChannels,
+                                  const std::array<int, maxLevels + 1> &counts) {
+  // 저역 출력을 중역 레벨까지 올려 중역과 더하고, 그 합을 원래 레이트까지
+  // 올립니다. 각 보간기는 분할 때 데시메이터가 내보낸 만큼을 받아 갑니다.
+  for (int k = lowLevel - 1; k >= 0; --k) {
+    const auto &source =
+        k + 1 == lowLevel ? bandBuffers[low] : raised[(size_t)k + 1];
+    auto &target = raised[(size_t)k];
+    synthesis[(size_t)k].interpolate(source.getArrayOfReadPointers(),
+                                     target.getArrayOfWritePointers(),
+                                     numChannels, counts[(size_t)k]);
+
+    if (k == midLevel)
+      for (int ch = 0; ch < numChannels; ++ch)
+        target.addFrom(ch, 0, bandBuffers[mid], ch, 0, counts[(size_t)k]);
+  }
+
+  for (int ch = 0; ch < numChannels; ++ch)
+    juce::FloatVectorOperations::add(buffer.getWritePointer(ch),
+                                     bandBuffers[high].getReadPointer(ch),
+                                     raised[0].getReadPointer(ch), counts[0]);
+}
+
+void MultibandShifter::delayBand(int band, int numChannels, int numSamples) {
+  const int delay = alignmentDelay[(size_t)band];
+  if (delay == 0)
+    return;
+
+  auto &ring = alignment[(size_t)band];
+
+  for (int ch = 0; ch < numChannels; ++ch) {
+    float *data = bandBuffers[(size_t)band].getWritePointer(ch);
+    ring.delayBlock(ch, data, data, numSamples, delay);
+  }
+
+  ring.advance(numSamples);
+}
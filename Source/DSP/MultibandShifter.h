@@ -0,0 +1,140 @@
+#pragma once
+
+#include "HalfbandFilter.h"
+#include "PitchEngine.h"
+#include "PitchShifter.h"
+#include <JuceHeader.h>
+
+// 대역 분할 그레인 피치 시프터.
+// 입력을 저/중/고 세 대역으로 나누고, 대역마다 다른 그레인 길이의
+// PitchShifter 로 시프트한 뒤 다시 더합니다. 고역은 짧은 그레인으로 워블을
+// 줄이고, 저역은 긴 그레인으로 드롭 튜닝 저음을 부드럽게 잇습니다.
+//
+// 대역은 하프밴드 피라미드로 나눕니다. 레벨 k 는 원래 레이트의 1/2^k 이고,
+// 하프밴드 데시메이터로 한 레벨씩 내려가며 크로스오버 레벨에서만 같은
+// 레이트 하프밴드로 한 번 거릅니다 (레벨 나이퀴스트의 1/2 이 크로스오버).
+// 아래 대역은 그 결과이고 위 대역은 지연을 맞춘 입력에서 빼서 얻으므로,
+// 선형 위상이라 두 대역의 합은 입력의 정확한 지연입니다 (LR 처럼 올패스
+// 보정이 필요 없음). 크로스오버 레벨은 샘플레이트마다 목표 주파수에 가장
+// 가까운 레벨로 정합니다 (48 kHz 에서 3 kHz 와 375 Hz).
+//
+// 대역 시프터는 자기 대역을 담을 수 있는 가장 낮은 레이트에서 돕니다.
+// 위로 시프트해도 크로스오버 경사 위쪽 성분이 나이퀴스트를 넘지 않도록
+// 크로스오버 레벨보다 한 레벨(저역은 두 레벨) 위, 즉 48 kHz 에서 고역 48,
+// 중역 24, 저역 6 kHz 입니다. 한 옥타브 넘게 올리면 크로스오버 경사 위쪽
+// 성분은 합성 보간기의 전이 대역에 걸려 줄어듭니다.
+//
+// 비용: 단일 그레인 엔진의 2배 안쪽이 목표였지만 닿지 못합니다. 대역
+// 시프터만 그레인 엔진의 약 1.5배이고, 원래 레이트 하프밴드 세 번(분할,
+// 상보 경로, 합성)과 24 kHz 네 번이 나머지를 더합니다. 모두 벡터화된
+// 상태입니다. YAMMYBenchmark 의 multiband / grain 비율은 512 블록 이상에서
+// 약 3.6배, 32 블록에서 약 8배입니다 (LR 크로스오버 구현은 512 블록 11배).
+//
+// 피치 0 에서 세 대역은 같은 지연으로 합쳐집니다. 대역마다 레이턴시가
+// 다르므로 빠른 대역에 정수 딜레이를 넣어 가장 느린 대역(저역)에 맞춥니다.
+class MultibandShifter : public PitchEngine {
+public:
+  MultibandShifter();
+  ~MultibandShifter() override;
+
+  void prepare(double sampleRate, int samplesPerBlock,
+               int numChannels) override;
+  void reset() override;
+  using PitchEngine::setPitch;
+  void setPitch(float semitones, int rampSamples) override;
+  void setInterpolationQuality(InterpolationQuality quality);
+  void setGrainHeads(int requestedHeads);
+  void setWindowShape(WindowShape shape);
+  void process(juce::AudioBuffer<float> &buffer) override;
+
+  // 대역별 그레인 길이가 고정이므로 레이턴시도 prepare 이후 일정합니다.
+  int getLatencySamples() const override { return latency; }
+  int getMaxLatencySamples() const override { return latency; }
+  int getTailSamples() const override { return tail; }
+
+private:
+  enum Band { low, mid, high, numBands };
+
+  // 피라미드 레벨 수 상한 (192 kHz 에서 저역 크로스오버 레벨이 7)
+  static constexpr int maxLevels = 8;
+
+  void splitBands(const juce::AudioBuffer<float> &buffer, int numChannels,
+                  std::array<int, maxLevels + 1> &counts);
+  void mergeBands(juce::AudioBuffer<float> &buffer, int numChannels,
+                  const std::array<int, maxLevels + 1> &counts);
+  void delayBand(int band, int numChannels, int numSamples);
+
+  // 레벨 from 에서 지연이 inner (그 레벨 샘플) 인 신호를 하프밴드 보간으로
+  // 레벨 to 까지 올렸을 때의 지연. spread 면 각 단의 FIR 길이 전체를 더해
+  // 응답이 끝나는 지점을 구합니다.
+  int raiseLatency(int inner, int from, int to, bool spread) const;
+  // 대역 출력이 합쳐지는 지점까지의 지연 (정렬 딜레이 제외)
+  int getBandLatency(int band, bool spread) const;
+
+  int getBandLevel(int band) const {
+    return band == low ? lowLevel : (band == mid ? midLevel : 0);
+  }
+
+  juce::AudioBuffer<float> makeView(juce::AudioBuffer<float> &source,
+                                    int numChannels, int numSamples) const {
+    return {source.getArrayOfWritePointers(), numChannels, numSamples};
+  }
+
+  double sampleRate = 44100.0;
+  int maxBlockSize = 0;
+  int latency = 0;
+  int tail = 0;
+
+  // 목표 크로스오버 주파수와 대역별 그레인 길이 (밀리초)
+  static constexpr double lowCrossover = 300.0;
+  static constexpr double highCrossover = 2500.0;
+  static constexpr std::array<float, numBands> bandGrainMs{90.0f, 40.0f,
+                                                           12.0f};
+
+  // 크로스오버 레벨과 대역 시프터 레벨 (prepare 에서 샘플레이트로 정함)
+  int highSplitLevel = 2;
+  int lowSplitLevel = 5;
+  int midLevel = 1;
+  int lowLevel = 3;
+
+  std::array<PitchShifter, numBands> shifters;
+
+  // 하프밴드 스펙: 나이퀴스트의 1/4 까지 통과, 3/4 부터 막습니다.
+  // 크로스오버 레벨에서 접히는 성분이 크로스오버 필터의 저지 대역에 떨어지고,
+  // 합칠 때 보간기가 한 옥타브 위로 시프트한 대역 출력까지 통과시킵니다.
+  static constexpr float halfbandTransition = 0.25f;
+  static constexpr float halfbandStopbandDb = -60.0f;
+
+  // analysis[k]: 레벨 k -> k+1 데시메이터. 짝인 보간기는 같은 신호를 되돌려
+  // 올리는 데 씁니다 (고역 크로스오버 위에서는 아래 대역을 원래 레이트로,
+  // 아래에서는 거른 저역을 고역 크로스오버 레벨로).
+  // synthesis[k]: 시프트한 저/중역 출력을 레벨 k+1 -> k 로 올리는 보간기.
+  // midInterpolator: 중역을 고역 크로스오버 레벨에서 중역 레벨로 올립니다.
+  std::array<HalfbandFilter, maxLevels> analysis;
+  std::array<HalfbandFilter, maxLevels> synthesis;
+  HalfbandFilter midInterpolator;
+  HalfbandFilter highSplit;
+  HalfbandFilter lowSplit;
+
+  // 레벨별 작업 버퍼 (prepare 에서 할당)
+  // levels[k]: 레벨 k 로 내린 신호 (고역 크로스오버 레벨부터는 아래 대역)
+  // roundTrip[k]: 거른 저역을 레벨 k 로 다시 올린 신호
+  // raised[k]: 아래 대역(상보 경로) 또는 시프트한 저/중역을 레벨 k 로 올린 신호
+  std::array<juce::AudioBuffer<float>, maxLevels + 1> levels;
+  std::array<juce::AudioBuffer<float>, maxLevels + 1> roundTrip;
+  std::array<juce::AudioBuffer<float>, maxLevels + 1> raised;
+  std::array<juce::AudioBuffer<float>, numBands> bandBuffers;
+
+  // 상보 대역을 얻기 위한 지연: 고역은 원래 레이트 입력을, 중역은 고역
+  // 크로스오버 레벨의 아래 대역을 각각 되돌려 올린 신호만큼 늦춥니다.
+  RingBuffer highComplement;
+  RingBuffer midComplement;
+  int highComplementDelay = 0;
+  int midComplementDelay = 0;
+
+  // 대역별 레이턴시 보정 딜레이 (대역 레벨 샘플, 가장 느린 대역에 맞춤)
+  std::array<RingBuffer, numBands> alignment;
+  std::array<int, numBands> alignmentDelay{};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultibandShifter)
+};
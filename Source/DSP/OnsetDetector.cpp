@@ -0,0 +1,71 @@
+#include "OnsetDetector.h"
+
+void OnsetDetector::prepare(double sampleRate) {
+  hopSize = juce::jmax(8, (int)std::round(sampleRate * hopSeconds));
+  averageCoefficient =
+      1.0f - std::exp(-(float)hopSize / (float)(sampleRate * averageSeconds));
+  refractoryHops =
+      (int)std::ceil(sampleRate * refractorySeconds / (double)hopSize);
+
+  reset();
+}
+
+void OnsetDetector::reset() {
+  hopFill = 0;
+  hopEnergy = 0.0f;
+  previousSample = 0.0f;
+  average = 0.0f;
+  refractoryRemaining = 0;
+}
+
+void OnsetDetector::setSensitivity(float newSensitivity) {
+  sensitivity = juce::jlimit(0.0f, 1.0f, newSensitivity);
+
+  // 감도 0..1 을 평균 대비 +18 dB .. +3 dB 의 에너지 상승으로 매핑합니다.
+  threshold = juce::Decibels::decibelsToGain(18.0f - 15.0f * sensitivity);
+}
+
+int OnsetDetector::process(const float *left, const float *right,
+                           int numSamples) {
+  int onset = -1;
+
+  for (int offset = 0; offset < numSamples;) {
+    const int n = juce::jmin(numSamples - offset, hopSize - hopFill);
+
+    // 모노 합의 1차 차분 에너지 (피크 어택의 고역 성분을 강조)
+    float previous = previousSample;
+    float energy = 0.0f;
+
+    for (int i = 0; i < n; ++i) {
+      const float x =
+          right != nullptr ? left[offset + i] + right[offset + i] : left[offset + i];
+      const float d = x - previous;
+      energy += d * d;
+      previous = x;
+    }
+
+    previousSample = previous;
+    hopEnergy += energy;
+    hopFill += n;
+    offset += n;
+
+    if (hopFill < hopSize)
+      continue;
+
+    const float hopMean = hopEnergy / (float)hopSize;
+
+    if (refractoryRemaining > 0) {
+      --refractoryRemaining;
+    } else if (onset < 0 && hopMean > energyFloor &&
+               hopMean > threshold * average) {
+      onset = offset;
+      refractoryRemaining = refractoryHops;
+    }
+
+    average += averageCoefficient * (hopMean - average);
+    hopEnergy = 0.0f;
+    hopFill = 0;
+  }
+
+  return onset;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// 가벼운 어택(온셋) 검출기.
+// 짧은 홉마다 1차 차분 신호(고역 강조)의 에너지를 구해 느린 평균과
+// 비교합니다. 블록당 비용은 샘플 수에 비례하는 곱셈-덧셈뿐입니다.
+class OnsetDetector {
+public:
+  void prepare(double sampleRate);
+  void reset();
+
+  // 0 = 끔, 1 = 가장 민감 (작은 에너지 상승에도 반응)
+  void setSensitivity(float newSensitivity);
+  bool isEnabled() const { return sensitivity > 0.0f; }
+  int getHopSize() const { return hopSize; }
+
+  // 블록을 분석해 이 블록 안에서 처음 검출된 어택의 위치(어택이 들어 있는
+  // 홉의 끝)를 돌려줍니다. 없으면 -1.
+  int process(const float *left, const float *right, int numSamples);
+
+private:
+  int hopSize = 64;
+  int hopFill = 0;
+  float hopEnergy = 0.0f;
+  float previousSample = 0.0f;
+
+  // 느린 에너지 평균 (약 50 ms 시정수)
+  float average = 0.0f;
+  float averageCoefficient = 0.0f;
+
+  float sensitivity = 0.0f;
+  float threshold = 1.0f; // 평균 대비 에너지 비율
+
+  // 같은 어택에 여러 번 반응하지 않도록 하는 휴지 기간
+  int refractoryHops = 0;
+  int refractoryRemaining = 0;
+
+  static constexpr double hopSeconds = 0.001;
+  static constexpr double averageSeconds = 0.05;
+  static constexpr double refractorySeconds = 0.06;
+  static constexpr float energyFloor = 1.0e-6f;
+};
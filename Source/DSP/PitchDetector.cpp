@@ -0,0 +1,171 @@
+#include "PitchDetector.h"
+
+PitchDetector::PitchDetector() {}
+
+PitchDetector::~PitchDetector() {}
+
+void PitchDetector::prepare(double sr, int samplesPerBlock) {
+  juce::ignoreUnused(samplesPerBlock);
+  sampleRate = sr;
+
+  // 최저 주파수의 주기 두 개가 창에 들어가야 NSDF 가 그 지연에서
+  // 충분히 겹칩니다. 선형 자기상관을 위해 FFT 는 창의 두 배로 잡습니다.
+  windowSize = juce::nextPowerOfTwo(
+      (int)std::ceil(2.0 * sampleRate / (double)minFrequency));
+  hopSize = windowSize / 4;
+  minLag = juce::jmax(2, (int)std::floor(sampleRate / (double)maxFrequency));
+  maxLag = windowSize / 2;
+
+  const int fftOrder = juce::roundToInt(std::log2((double)windowSize)) + 1;
+  fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+  fifo.allocate((size_t)windowSize, true);
+  spectrum.allocate((size_t)(2 * fft->getSize()), true);
+  nsdf.allocate((size_t)(maxLag + 1), true);
+
+  reset();
+}
+
+void PitchDetector::reset() {
+  if (fifo != nullptr)
+    juce::FloatVectorOperations::clear(fifo.get(), windowSize);
+
+  fifoFill = 0;
+  periodSamples.store(0.0f, std::memory_order_relaxed);
+  confidence.store(0.0f, std::memory_order_relaxed);
+  clarity.store(0.0f, std::memory_order_relaxed);
+}
+
+void PitchDetector::process(const juce::AudioBuffer<float> &buffer) {
+  const int numChannels = buffer.getNumChannels();
+  const int numSamples = buffer.getNumSamples();
+
+  if (numChannels == 0 || fifo == nullptr)
+    return;
+
+  const float channelGain = 1.0f / (float)numChannels;
+
+  for (int offset = 0; offset < numSamples;) {
+    // 창이 찰 때까지 모노 합을 블록 단위로 채웁니다.
+    const int n = juce::jmin(numSamples - offset, windowSize - fifoFill);
+    float *dest = fifo.get() + fifoFill;
+
+    juce::FloatVectorOperations::copyWithMultiply(
+        dest, buffer.getReadPointer(0, offset), channelGain, n);
+    for (int ch = 1; ch < numChannels; ++ch)
+      juce::FloatVectorOperations::addWithMultiply(
+          dest, buffer.getReadPointer(ch, offset), channelGain, n);
+
+    fifoFill += n;
+    offset += n;
+
+    if (fifoFill == windowSize) {
+      analyse();
+
+      // 한 홉만큼 밀어 다음 분석 창을 준비합니다.
+      std::memmove(fifo.get(), fifo.get() + hopSize,
+                   (size_t)(windowSize - hopSize) * sizeof(float));
+      fifoFill = windowSize - hopSize;
+    }
+  }
+}
+
+void PitchDetector::analyse() {
+  const float *x = fifo.get();
+  float *work = spectrum.get();
+  const int fftSize = fft->getSize();
+
+  // 창의 총 에너지 (r(0)). 무음이면 이전 주기는 유지하고 신뢰도만 내립니다.
+  float energy = 0.0f;
+  for (int i = 0; i < windowSize; ++i)
+    energy += x[i] * x[i];
+
+  if (energy < silenceThreshold * (float)windowSize) {
+    confidence.store(0.0f, std::memory_order_relaxed);
+    clarity.store(0.0f, std::memory_order_relaxed);
+    return;
+  }
+
+  // 자기상관 r(tau) = IFFT(|FFT(x)|^2), 뒤쪽 절반은 0으로 채워 순환을 막습니다.
+  juce::FloatVectorOperations::copy(work, x, windowSize);
+  juce::FloatVectorOperations::clear(work + windowSize,
+                                     2 * fftSize - windowSize);
+  fft->performRealOnlyForwardTransform(work, true);
+
+  for (int k = 0; k <= fftSize / 2; ++k) {
+    const float re = work[2 * k];
+    const float im = work[2 * k + 1];
+    work[2 * k] = re * re + im * im;
+    work[2 * k + 1] = 0.0f;
+  }
+
+  fft->performRealOnlyInverseTransform(work);
+
+  // 변환 구현마다 역변환 스케일이 다를 수 있으므로 r(0)을 에너지에 맞춥니다.
+  const float scale = work[0] > 0.0f ? energy / work[0] : 0.0f;
+
+  // NSDF n(tau) = 2 r(tau) / m(tau), m(tau) = sum(x[j]^2 + x[j+tau]^2)
+  // m 은 양 끝 샘플을 하나씩 빼며 증분적으로 구합니다.
+  float m = 2.0f * energy;
+  nsdf[0] = 1.0f;
+
+  for (int tau = 1; tau <= maxLag; ++tau) {
+    m -= x[tau - 1] * x[tau - 1] + x[windowSize - tau] * x[windowSize - tau];
+    nsdf[tau] = m > 0.0f ? 2.0f * scale * work[tau] / m : 0.0f;
+  }
+
+  // 첫 음수 구간 이후 양수 구간마다 최댓값(key maximum)을 찾습니다.
+  constexpr int maxCandidates = 32;
+  std::array<int, maxCandidates> candidates;
+  int numCandidates = 0;
+  float highest = 0.0f;
+
+  int tau = 1;
+  while (tau < maxLag && nsdf[tau] > 0.0f)
+    ++tau;
+
+  while (tau < maxLag && numCandidates < maxCandidates) {
+    while (tau < maxLag && nsdf[tau] <= 0.0f)
+      ++tau;
+
+    int best = tau;
+    while (tau < maxLag && nsdf[tau] > 0.0f) {
+      if (nsdf[tau] > nsdf[best])
+        best = tau;
+      ++tau;
+    }
+
+    // 창 끝에서 잘린 구간은 최댓값이 확정되지 않았으므로 버립니다.
+    if (tau < maxLag && best >= minLag) {
+      candidates[(size_t)numCandidates++] = best;
+      highest = juce::jmax(highest, nsdf[best]);
+    }
+  }
+
+  if (numCandidates == 0) {
+    confidence.store(0.0f, std::memory_order_relaxed);
+    clarity.store(0.0f, std::memory_order_relaxed);
+    return;
+  }
+
+  int chosen = candidates[0];
+  for (int c = 0; c < numCandidates; ++c)
+    if (nsdf[candidates[(size_t)c]] >= peakThreshold * highest) {
+      chosen = candidates[(size_t)c];
+      break;
+    }
+
+  // 포물선 보간으로 분수 지연과 정점 값을 구합니다.
+  const float left = nsdf[chosen - 1];
+  const float centre = nsdf[chosen];
+  const float right = nsdf[chosen + 1];
+  const float denominator = left - 2.0f * centre + right;
+  const float shift =
+      denominator < 0.0f ? 0.5f * (left - right) / denominator : 0.0f;
+  const float peak = centre - 0.25f * (left - right) * shift;
+
+  periodSamples.store((float)chosen + shift, std::memory_order_relaxed);
+  confidence.store(juce::jlimit(0.0f, 1.0f, peak), std::memory_order_relaxed);
+  clarity.store(juce::jlimit(0.0f, 1.0f, nsdf[candidates[0]]),
+                std::memory_order_relaxed);
+}
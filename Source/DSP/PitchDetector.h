@@ -0,0 +1,70 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// McLeod 피치 검출기 (NSDF).
+// 입력의 모노 합을 고정 홉마다 분석하고, 자기상관은 juce::dsp::FFT 로
+// 한 번의 정방향/역방향 실수 변환으로 구합니다. 결과(주기, 신뢰도)는
+// 원자 변수로 게시되어 엔진과 UI가 잠금 없이 읽을 수 있습니다.
+class PitchDetector {
+public:
+  PitchDetector();
+  ~PitchDetector();
+
+  void prepare(double sampleRate, int samplesPerBlock);
+  void reset();
+  void process(const juce::AudioBuffer<float> &buffer);
+
+  // 마지막으로 검출된 주기 (샘플). 검출된 적이 없으면 0.
+  float getPeriodSamples() const {
+    return periodSamples.load(std::memory_order_relaxed);
+  }
+
+  float getFrequency() const {
+    const float period = getPeriodSamples();
+    return period > 0.0f ? (float)sampleRate / period : 0.0f;
+  }
+
+  // 0(무음/비주기) .. 1(완전한 주기 신호)
+  float getConfidence() const {
+    return confidence.load(std::memory_order_relaxed);
+  }
+
+  // 가장 짧은 지연의 NSDF 최댓값 (0..1). 단음은 첫 최댓값이 곧 주기라
+  // 1에 가깝고, 화음은 공통 주기가 길어 앞쪽 최댓값이 낮게 나옵니다.
+  // 단음/화음 분류에 씁니다.
+  float getClarity() const { return clarity.load(std::memory_order_relaxed); }
+
+  // 검출 범위 (Hz). 드롭 튜닝 베이스부터 기타 리드 음역까지.
+  static constexpr float minFrequency = 55.0f;
+  static constexpr float maxFrequency = 1500.0f;
+
+private:
+  void analyse();
+
+  double sampleRate = 44100.0;
+
+  // 분석 창은 최저 주파수 주기의 두 배 이상, 홉은 창의 1/4
+  int windowSize = 0;
+  int hopSize = 0;
+  int minLag = 0;
+  int maxLag = 0;
+  int fifoFill = 0;
+
+  std::unique_ptr<juce::dsp::FFT> fft;
+  juce::HeapBlock<float> fifo;     // 최근 windowSize 샘플 (모노 합)
+  juce::HeapBlock<float> spectrum; // 2 * fftSize (실수 변환 작업 영역)
+  juce::HeapBlock<float> nsdf;     // maxLag + 1
+
+  std::atomic<float> periodSamples{0.0f};
+  std::atomic<float> confidence{0.0f};
+  std::atomic<float> clarity{0.0f};
+
+  // 최댓값 후보 중 최댓값 대비 이 비율 이상인 첫 후보를 주기로 고릅니다.
+  static constexpr float peakThreshold = 0.9f;
+  // 창 평균 파워가 이보다 작으면 무음으로 보고 신뢰도를 0으로 둡니다.
+  static constexpr float silenceThreshold = 1.0e-7f;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PitchDetector)
+};
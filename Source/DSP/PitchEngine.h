@@ -0,0 +1,46 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// 피치 시프트 엔진 공통 인터페이스.
+// 프로세서는 인스턴스마다 이 인터페이스로 엔진을 골라 쓰고,
+// 원음 경로와 호스트에는 엔진이 보고하는 레이턴시를 그대로 전달합니다.
+class PitchEngine {
+public:
+  virtual ~PitchEngine() = default;
+
+  // numChannels 는 버스 레이아웃의 채널 수로, 엔진은 그만큼만 히스토리를 잡습니다.
+  virtual void prepare(double sampleRate, int samplesPerBlock,
+                       int numChannels) = 0;
+  virtual void reset() = 0;
+
+  // 음정(반음)을 rampSamples 동안 반음 단위로 선형 램프해 바꿉니다 (PitchRamp).
+  // 0 이면 다음 샘플부터 바로 바뀝니다. 엔진은 이 램프를 샘플 단위로
+  // 따라가며, 따로 스무딩하지 않습니다.
+  virtual void setPitch(float semitones, int rampSamples) = 0;
+  void setPitch(float semitones) { setPitch(semitones, 0); }
+
+  virtual void process(juce::AudioBuffer<float> &buffer) = 0;
+
+  // 바이패스 중 process 대신 호출됩니다. 히스토리를 싸게 이어 둘 수 있는
+  // 엔진은 입력만 기록하고 true 를 돌려줍니다. false 면 프로세서가 재개
+  // 직전에 reset 해 오래된 소리가 나오지 않게 합니다.
+  virtual bool keepWarm(const juce::AudioBuffer<float> &input) {
+    juce::ignoreUnused(input);
+    return false;
+  }
+
+  // 현재 원음 대비 지연 (샘플)과 prepare 이후 가능한 최댓값
+  virtual int getLatencySamples() const = 0;
+  virtual int getMaxLatencySamples() const = 0;
+
+  // 모든 엔진의 최대 레이턴시 상한 (초). 프로세서는 아직 준비하지 않은
+  // 엔진의 레이턴시를 모르므로 원음 딜레이 라인을 이 상한으로 잡습니다.
+  // 가장 긴 스펙트럼 엔진의 프레임(85 ms 를 2의 거듭제곱 샘플로 올림)도
+  // 어떤 샘플레이트에서든 이 안에 듭니다.
+  static constexpr double maxLatencySeconds = 0.175;
+
+  // 입력이 끝난 뒤에도 출력이 이어질 수 있는 최대 샘플 수 (prepare 이후 일정).
+  // 기본값은 윈도우 중심만큼 지연되는 엔진의 윈도우 전체 길이입니다.
+  virtual int getTailSamples() const { return 2 * getMaxLatencySamples(); }
+};
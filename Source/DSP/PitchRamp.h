@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// 음정(반음) 선형 램프.
+// 목표와 램프 길이(샘플)를 받아 샘플마다 같은 기울기로 움직이고, 길이가
+// 0 이면 바로 옮깁니다. 램프 중에 새 목표가 오면 지금 값에서 다시
+// 출발합니다. 값은 반음(비율의 로그 영역)이므로 비율로는 지수 곡선입니다.
+//
+// MidiPitchControl 이 노트, 글라이드, 페달, 노브를 (목표, 길이)로 정하고
+// 엔진은 같은 램프를 샘플 단위로 따라갑니다. 스무딩은 이 한 곳뿐입니다.
+class PitchRamp {
+public:
+  void setTarget(float semitones, int rampSamples) {
+    origin = getCurrentValue();
+    target = semitones;
+    elapsed = 0;
+    length = juce::jmax(0, rampSamples);
+    step = length > 0 ? (target - origin) / (float)length : 0.0f;
+  }
+
+  // 램프를 끝내고 목표로 옮깁니다.
+  void finish() { setTarget(target, 0); }
+
+  float getCurrentValue() const { return getValueAt(0); }
+  float getTargetValue() const { return target; }
+  int getRemainingSamples() const { return length - elapsed; }
+  bool isRamping() const { return elapsed < length; }
+
+  // offset 샘플 뒤의 값 (램프가 끝난 뒤면 목표).
+  // 값은 램프 시작점에서 바로 계산하므로 블록을 어떻게 나눠 읽어도
+  // 같은 샘플에서 같은 값이 나옵니다.
+  float getValueAt(int offset) const {
+    const int position = elapsed + offset;
+    return position >= length ? target : origin + step * (float)position;
+  }
+
+  // 블록의 샘플별 값을 dest[0..numSamples) 에 씁니다.
+  void fill(float *dest, int numSamples) const {
+    const int n = juce::jmin(numSamples, getRemainingSamples());
+
+    for (int i = 0; i < n; ++i)
+      dest[i] = origin + step * (float)(elapsed + i);
+
+    juce::FloatVectorOperations::fill(dest + n, target, numSamples - n);
+  }
+
+  void skip(int numSamples) {
+    elapsed = juce::jmin(length, elapsed + numSamples);
+  }
+
+private:
+  float origin = 0.0f;
+  float target = 0.0f;
+  float step = 0.0f;
+  int elapsed = 0;
+  int length = 0;
+};
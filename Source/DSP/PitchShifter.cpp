@@ -1,233 +1,1003 @@
 #include "PitchShifter.h"
+#include "FastMath.h"
+
+using SimdLanes::padToWidth;
 
 PitchShifter::PitchShifter() {}
 
 PitchShifter::~PitchShifter() {}
 
-void PitchShifter::prepare(double sr, int samplesPerBlock) {
+void PitchShifter::prepare(double sr, int samplesPerBlock, int numChannels) {
   sampleRate = sr;
-  // 윈도우를 위해 충분한 크기 또는 몇 초 분량을 담을 수 있도록 버퍼 크기 설정
-  // 단순 피치 시프팅을 위해 충분한 히스토리가 필요합니다.
-  // 합리적으로 큰 버퍼를 사용합니다.
-  bufferSize = (int)(sampleRate * 2.0);
-  delayBuffer.setSize(2, bufferSize);
-  delayBuffer.clear();
+  chunkSize = juce::jlimit(1, maxChunkSize, samplesPerBlock);
+  const int paddedBlock = padToWidth(chunkSize);
+
+  // 히스토리는 최대 그레인 길이 기준으로 여기서 한 번만 크기를 정합니다.
+  // 한 청크를 먼저 기록한 뒤 그 시작점에서 최대 딜레이 + 보간 탭만큼
+  // 과거를 읽고, 스플라이스 탐색은 거기서 최대 지연 + 비교 구간만큼 더
+  // 과거를 읽으므로 그만큼을 담을 수 있어야 합니다.
+  // 용량은 2의 거듭제곱으로 올림되어 마스크로 래핑되고, 채널은 버스에
+  // 실제로 있는 만큼만 둡니다.
+  maxGrainLength = (int)std::ceil(sampleRate * maxGrainMs / 1000.0);
+  maxSpliceLag = (int)std::ceil(sampleRate * spliceLagSeconds);
+  spliceWindow = (int)std::ceil(sampleRate * spliceWindowSeconds);
+  numBusChannels = juce::jmax(1, numChannels);
+  voiceChannel = numBusChannels > 1 && harmonyCapacity > 0 ? numBusChannels : 0;
+  history.setSize(juce::jmax(numBusChannels, voiceChannel + 1),
+                  maxGrainLength + maxSpliceLag + spliceWindow + paddedBlock +
+                      Interpolators::maxLookahead + Interpolators::maxFirstTap +
+                      2,
+                  historyGuard);
+
+  // 스플라이스 탐색용 기준 구간과 후보 구간
+  spliceScratch.allocate((size_t)(2 * spliceWindow + maxSpliceLag), true);
+
+  onsetDetector.prepare(sampleRate);
+  transientFade = juce::jmax(1, (int)std::round(sampleRate * transientFadeSeconds));
+
+  sweepPhase.allocate((size_t)paddedBlock + 1, true);
+
+  grainLength.reset(sampleRate, grainLengthRampSeconds);
+
+  for (auto &voice : harmonyVoices) {
+    voice.gain.reset(sampleRate, voiceGainRampSeconds);
+    for (auto &b : voice.balance)
+      b.reset(sampleRate, voiceGainRampSeconds);
+  }
+  updateGrainLengthLimit();
+  grainLength.setCurrentAndTargetValue(
+      juce::jmin((float)(sampleRate * grainLengthMs / 1000.0),
+                 (float)grainLengthLimit));
+
+  // 청크 램프는 여기서 한 번만 할당합니다. 크기는 호스트 블록이 아니라
+  // 청크 크기를 따르고, 헤드 행은 보이스들이 돌려 쓰므로 보이스 용량과
+  // 무관합니다 (용량이 0 이면 보이스 게인 행도 잡지 않습니다).
+  numMixRows = numBusChannels;
+  mixRow = maxGrainHeads * 2;
+  sweepRow = mixRow + numMixRows;
+  voiceGainRow = sweepRow + 1;
+  numRampRows = voiceGainRow + juce::jmin(harmonyCapacity, maxVoicesPerPass) *
+                                   juce::jmin(numMixRows, maxPanChannels);
+  ramps = juce::dsp::AudioBlock<float>(rampMemory, (size_t)numRampRows,
+                                       (size_t)paddedBlock);
+  readIndex.allocate((size_t)(maxGrainHeads * paddedBlock), true);
+
+  // 공유 sinc/윈도우 테이블을 오디오 스레드 밖에서 미리 만들어 둡니다.
+  Interpolators::Sinc::getTable();
+  updateWindow();
 
   reset();
 }
 
 void PitchShifter::reset() {
-  delayBuffer.clear();
-  writePos = 0;
-  readPos = 0.0f;
+  history.clear();
+  grainPhase = 0;
+  pitch.finish();
+  // 히스토리가 비었으니 그레인 길이도 램프 없이 목표로 옮겨, 보고하는
+  // 레이턴시가 곧바로 새 설정을 따르게 합니다.
+  grainLength.setCurrentAndTargetValue(grainLength.getTargetValue());
+  spliceOffset.fill(0.0f);
+  onsetDetector.reset();
+  transientStage = TransientStage::idle;
+
+  // 켜진 보이스는 램프 없이 바로 제 레벨로, 꺼진 보이스는 바로 뺍니다.
+  for (auto &voice : harmonyVoices) {
+    voice.phase = 0;
+    voice.gain.setCurrentAndTargetValue(voice.gain.getTargetValue());
+    for (auto &b : voice.balance)
+      b.setCurrentAndTargetValue(b.getTargetValue());
+  }
+
+  numHarmonyVoices = harmonyVoiceCount;
+}
+
+void PitchShifter::setPitch(float semitones, int rampSamples) {
+  pitch.setTarget(semitones, rampSamples);
+}
+
+void PitchShifter::setInterpolationQuality(InterpolationQuality quality) {
+  interpolationQuality = quality;
 }
 
-void PitchShifter::setPitch(float semitones) {
-  if (currentPitch != semitones) {
-    currentPitch = semitones;
-    updatePitchRatio();
+void PitchShifter::setGrainHeads(int requestedHeads) {
+  // 지원하는 헤드 수 중 요청 이상인 가장 작은 값으로 맞춥니다.
+  int newNumHeads = grainHeadCounts.back();
+  for (auto count : grainHeadCounts)
+    if (count >= requestedHeads) {
+      newNumHeads = count;
+      break;
+    }
+
+  if (numHeads != newNumHeads) {
+    numHeads = newNumHeads;
+    updateWindow();
   }
 }
 
-void PitchShifter::updatePitchRatio() {
-  // 반음에서 피치 비율 계산
-  // 비율 = 2^(반음 / 12)
-  pitchRatio = std::pow(2.0f, currentPitch / 12.0f);
+void PitchShifter::setWindowShape(WindowShape shape) {
+  if (windowShape != shape) {
+    windowShape = shape;
+    updateWindow();
+  }
+}
+
+void PitchShifter::updateWindow() {
+  // 해석적으로 계산할 수 있는 조합은 테이블 대신 배율만 곱합니다.
+  const float scale = GrainWindows::analyticScale(windowShape, numHeads);
+  windowTable = GrainWindows::getTable(windowShape, numHeads);
+  windowScale = scale > 0.0f ? scale : 1.0f;
+}
+
+void PitchShifter::setGrainLength(float milliseconds) {
+  grainLengthMs = juce::jlimit(minGrainMs, maxGrainMs, milliseconds);
+  updateGrainLengthTarget();
+}
+
+void PitchShifter::setGrainLengthLimit(float milliseconds) {
+  grainLengthLimitMs = juce::jlimit(minGrainMs, maxGrainMs, milliseconds);
+  const int previousLimit = grainLengthLimit;
+  updateGrainLengthLimit();
+  updateGrainLengthTarget();
+
+  // 상한이 바뀌면 헤드 중심(레이턴시)이 한 번에 옮겨지므로 길이도 램프 없이
+  // 같이 옮깁니다. 램프 중인 길이가 새 상한보다 길면 아직 기록되지 않은
+  // 입력을 읽게 됩니다.
+  if (grainLengthLimit != previousLimit)
+    grainLength.setCurrentAndTargetValue(
+        juce::jmin(grainLength.getTargetValue(), (float)grainLengthLimit));
+}
+
+void PitchShifter::updateGrainLengthLimit() {
+  // 짝수로 내려, 반 그레인(레이턴시)이 정수이면서 상한 길이의 헤드도
+  // 보간 여유분 안쪽을 읽지 않게 합니다.
+  grainLengthLimit =
+      juce::jmin(maxGrainLength,
+                 (int)std::ceil(sampleRate * grainLengthLimitMs / 1000.0)) &
+      ~1;
+}
+
+void PitchShifter::setAdaptiveGrain(bool shouldAdapt) {
+  if (adaptiveGrain != shouldAdapt) {
+    adaptiveGrain = shouldAdapt;
+    updateGrainLengthTarget();
+  }
+}
+
+void PitchShifter::setDetectedPeriod(float periodSamples, float confidence) {
+  if (confidence < minPeriodConfidence || periodSamples <= 0.0f)
+    return;
+
+  // 최소 그레인 길이와 minGrainPeriods 주기 중 긴 쪽을 덮는 가장 작은
+  // 정수배. 최대 길이를 넘으면 그 안에 들어가는 가장 큰 정수배로 줄입니다.
+  const float minLength = (float)(sampleRate * minGrainMs / 1000.0);
+  float periods = juce::jmax((float)minGrainPeriods,
+                             std::ceil(minLength / periodSamples));
+
+  const auto limit = (float)grainLengthLimit;
+
+  if (periods * periodSamples > limit)
+    periods = juce::jmax(1.0f, std::floor(limit / periodSamples));
+
+  adaptiveLength = juce::jmin(periods * periodSamples, limit);
+  updateGrainLengthTarget();
+}
+
+void PitchShifter::updateGrainLengthTarget() {
+  const float target = juce::jmin(
+      adaptiveGrain && adaptiveLength > 0.0f
+          ? adaptiveLength
+          : (float)(sampleRate * grainLengthMs / 1000.0),
+      (float)grainLengthLimit);
+
+  // 검출 주기의 미세한 흔들림마다 램프를 다시 시작하지 않도록
+  // 1% 이상 달라질 때만 목표를 바꿉니다.
+  if (std::abs(target - grainLength.getTargetValue()) > 0.01f * target)
+    grainLength.setTargetValue(target);
+}
+
+void PitchShifter::setSpliceAlignment(bool shouldAlign) {
+  // 끌 때 오프셋을 바로 지우면 딜레이가 튀므로, 각 헤드의 다음 래핑에서
+  // 0으로 돌아가게 둡니다.
+  spliceAlignment = shouldAlign;
+}
+
+void PitchShifter::setTransientSensitivity(float sensitivity) {
+  onsetDetector.setSensitivity(sensitivity);
+}
+
+void PitchShifter::setHarmonyCapacity(int maxVoices) {
+  harmonyCapacity = juce::jlimit(0, maxHarmonyVoices, maxVoices);
+  numHarmonyVoices = juce::jmin(numHarmonyVoices, harmonyCapacity);
+  setHarmonyVoiceCount(harmonyVoiceCount);
+
+  for (int v = harmonyCapacity; v < maxHarmonyVoices; ++v)
+    harmonyVoices[(size_t)v].enabled = false;
+}
+
+size_t PitchShifter::getFootprintBytes() const {
+  const auto historyBytes = (size_t)history.getNumChannels() *
+                            (size_t)(history.getCapacity() + history.getGuard()) *
+                            sizeof(float);
+  const auto rampBytes =
+      ramps.getNumChannels() * ramps.getNumSamples() * sizeof(float);
+  const auto indexBytes =
+      (size_t)maxGrainHeads * (size_t)padToWidth(chunkSize) * sizeof(int);
+
+  return historyBytes + rampBytes + indexBytes;
+}
+
+void PitchShifter::setHarmonyVoiceCount(int count) {
+  harmonyVoiceCount = juce::jlimit(0, harmonyCapacity, count);
+
+  for (int v = 0; v < harmonyCapacity; ++v) {
+    auto &voice = harmonyVoices[(size_t)v];
+    const bool enable = v < harmonyVoiceCount;
+
+    // 렌더링에서 빠졌던 보이스는 지난 위상이 의미 없으므로 주 보이스와
+    // 같은 위상에서 레벨 0 부터 시작합니다. 페이드아웃 중에 다시 켜면
+    // 그 자리에서 레벨만 되돌립니다.
+    if (enable && !voice.enabled && v >= numHarmonyVoices) {
+      voice.phase = grainPhase;
+      voice.gain.setCurrentAndTargetValue(0.0f);
+    }
+
+    voice.enabled = enable;
+    voice.gain.setTargetValue(enable ? voice.level : 0.0f);
+  }
+
+  numHarmonyVoices = juce::jmax(numHarmonyVoices, harmonyVoiceCount);
+}
+
+void PitchShifter::setHarmonyVoice(int voice, float semitones, float level,
+                                   float pan) {
+  if (!juce::isPositiveAndBelow(voice, harmonyCapacity))
+    return;
+
+  auto &v = harmonyVoices[(size_t)voice];
+  v.ratio = FastMath::semitonesToRatio(semitones);
+  v.level = level;
+
+  if (v.enabled)
+    v.gain.setTargetValue(level);
+
+  // 밸런스 법칙: 가운데에서 양쪽 모두 원래 레벨, 한쪽으로 갈수록 반대쪽만 줄입니다.
+  pan = juce::jlimit(-1.0f, 1.0f, pan);
+  v.balance[0].setTargetValue(juce::jmin(1.0f, 1.0f - pan));
+  v.balance[1].setTargetValue(juce::jmin(1.0f, 1.0f + pan));
+}
+
+void PitchShifter::writeVoiceSource(const juce::AudioBuffer<float> &input,
+                                    int numChannels, int offset,
+                                    int numSamples) {
+  // 보이스용 mid 채널을 기록합니다. 청크 믹스 행은 렌더링 전까지 비어
+  // 있으므로 첫 행을 작업 공간으로 씁니다.
+  if (voiceChannel == 0)
+    return;
+
+  auto *mid = ramps.getChannelPointer((size_t)mixRow);
+
+  if (numChannels > 1) {
+    juce::FloatVectorOperations::add(mid, input.getReadPointer(0, offset),
+                                     input.getReadPointer(1, offset),
+                                     numSamples);
+    juce::FloatVectorOperations::multiply(mid, 0.5f, numSamples);
+  } else {
+    juce::FloatVectorOperations::copy(mid, input.getReadPointer(0, offset),
+                                      numSamples);
+  }
+
+  history.writeBlock(voiceChannel, mid, numSamples);
+}
+
+void PitchShifter::generateVoiceGains(int voice, int gainRow, int panChannels,
+                                      int numSamples, int paddedSamples) {
+  // 보이스의 채널 게인 행을 채웁니다. 팬은 스테레오 출력에서만 적용하고,
+  // 램프가 없으면 상수로 채웁니다. 패딩 구간은 마지막 값입니다.
+  auto &v = harmonyVoices[(size_t)voice];
+  const bool stereo = panChannels == 2;
+  std::array<float *, maxPanChannels> rows{};
+
+  for (int c = 0; c < panChannels; ++c)
+    rows[(size_t)c] = ramps.getChannelPointer((size_t)(gainRow + c));
+
+  const bool ramping =
+      v.gain.isSmoothing() ||
+      (stereo && (v.balance[0].isSmoothing() || v.balance[1].isSmoothing()));
+
+  int from = 0;
+  if (ramping) {
+    for (; from < numSamples; ++from) {
+      const float gain = v.gain.getNextValue();
+
+      if (stereo) {
+        rows[0][from] = gain * v.balance[0].getNextValue();
+        rows[1][from] = gain * v.balance[1].getNextValue();
+      } else {
+        rows[0][from] = gain;
+      }
+    }
+  }
+
+  // 모노 출력에서도 팬 램프는 같은 시간만큼 진행시킵니다.
+  if (!stereo)
+    for (auto &b : v.balance)
+      b.skip(numSamples);
+
+  const float gain = v.gain.getCurrentValue();
+  for (int c = 0; c < panChannels; ++c)
+    juce::FloatVectorOperations::fill(
+        rows[(size_t)c] + from,
+        stereo ? gain * v.balance[(size_t)c].getCurrentValue() : gain,
+        paddedSamples - from);
+}
+
+void PitchShifter::releaseSilentVoices() {
+  // 꺼진 뒤 페이드아웃이 끝난 보이스를 뒤에서부터 렌더링에서 뺍니다.
+  while (numHarmonyVoices > harmonyVoiceCount) {
+    const auto &voice = harmonyVoices[(size_t)numHarmonyVoices - 1];
+    if (voice.gain.isSmoothing())
+      break;
+
+    --numHarmonyVoices;
+  }
+}
+
+juce::uint32 PitchShifter::preparePitchSweep(float length, int numSamples,
+                                             int paddedSamples) {
+  // 반음에서 피치 비율 계산: 비율 = 2^(반음 / 12)
+  // 돌려주는 증가량은 청크 끝 음정 기준이며, 램프가 없으면 청크 전체에
+  // 그대로 쓰입니다.
+  const float start = pitch.getCurrentValue();
+  sweeping = pitch.isRamping();
+  sweepLength = numSamples;
+
+  if (!sweeping)
+    return getPhaseIncrement(length, FastMath::semitonesToRatio(start));
+
+  // 샘플별 음정을 램프에서 그대로 받아 비율로 바꿉니다. 램프가 청크
+  // 중간에 끝나면 나머지는 목표 음정입니다.
+  auto *ratio = ramps.getChannelPointer((size_t)sweepRow);
+  pitch.fill(ratio, paddedSamples);
+  juce::FloatVectorOperations::multiply(ratio, 1.0f / 12.0f, paddedSamples);
+  FastMath::exp2(ratio, ratio, paddedSamples);
+
+  const float end = pitch.getValueAt(numSamples);
+  pitch.skip(numSamples);
+
+  // 샘플별 증가량(getPhaseIncrement 와 같은 식)을 누적합니다.
+  // 청크 안의 위상은 모두 이 누적값을 쓰므로 오차가 있어도 서로 어긋나지
+  // 않습니다.
+  const float cycleScale = 4294967296.0f / length;
+  sweepPhase[0] = 0;
+
+  for (int i = 0; i < paddedSamples; ++i)
+    sweepPhase[i + 1] =
+        sweepPhase[i] +
+        (juce::uint32)(juce::int32)((1.0f - ratio[i]) * cycleScale);
+
+  return getPhaseIncrement(length, FastMath::semitonesToRatio(end));
+}
+
+juce::uint32 PitchShifter::getPhaseIncrement(float length, float ratio) const {
+  // 읽기 헤드는 샘플당 (1 - ratio) 샘플씩 딜레이가 변합니다.
+  // 이를 윈도우 한 바퀴(2^32) 기준의 고정 소수점 증가량으로 바꿉니다.
+  // 음수 증가량은 2의 보수로 저장되어 덧셈 오버플로로 자연스럽게 래핑됩니다.
+  // preparePitchSweep 의 샘플별 누적과 같은 식이어야 램프가 끝난 뒤의
+  // 위상이 청크를 어떻게 나눴는지와 무관해집니다.
+  const float cycleScale = 4294967296.0f / length;
+  return (juce::uint32)(juce::int32)((1.0f - ratio) * cycleScale);
+}
+
+juce::uint32 PitchShifter::getHeadOffset(int head) const {
+  // 헤드는 윈도우 한 바퀴를 numHeads 등분한 위상 오프셋을 가집니다.
+  return (juce::uint32)(((juce::uint64)head << 32) / (juce::uint64)numHeads);
+}
+
+juce::uint32 PitchShifter::getHeadPhase(int head, int sample,
+                                        juce::uint32 increment) const {
+  return grainPhase + getHeadOffset(head) +
+         (sweeping ? sweepPhase[sample] : (juce::uint32)sample * increment);
+}
+
+int PitchShifter::samplesUntilWrap(int head, int sample,
+                                   juce::uint32 increment) const {
+  // 위상이 2^32 경계를 넘어 새 그레인이 시작되는 첫 샘플까지의 거리
+  if (sweeping) {
+    // 증가량이 샘플마다 다르므로 청크 안에서 직접 찾습니다.
+    juce::uint32 phase = getHeadPhase(head, sample, increment);
+
+    for (int i = sample + 1; i <= sweepLength; ++i) {
+      const auto delta = (juce::int32)(sweepPhase[i] - sweepPhase[i - 1]);
+      const juce::uint32 next = phase + (juce::uint32)delta;
+
+      if (delta > 0 ? next < phase : next > phase)
+        return i - sample;
+
+      phase = next;
+    }
+
+    return std::numeric_limits<int>::max();
+  }
+
+  const auto step = (juce::int64)(juce::int32)increment;
+
+  if (step == 0)
+    return std::numeric_limits<int>::max();
+
+  const juce::uint64 phase = getHeadPhase(head, sample, increment);
+  const juce::uint64 steps =
+      step > 0 ? (0x100000000ull - phase + (juce::uint64)step - 1) /
+                     (juce::uint64)step
+               : phase / (juce::uint64)(-step) + 1;
+
+  return (int)juce::jmin(steps, (juce::uint64)std::numeric_limits<int>::max());
+}
+
+juce::uint32 PitchShifter::getRephaseTarget(juce::uint32 increment) const {
+  // 어택은 검출 홉의 시작과 페이드아웃 사이 어딘가에 있습니다. 그 시점이
+  // 레이턴시 뒤에 헤드 0 의 위상 0.5 (딜레이 = 레이턴시)와 만나도록
+  // 지금의 위상을 거꾸로 구합니다. 부호 있는 증분이라 피치 상승도 같습니다.
+  const int elapsed = transientFade + onsetDetector.getHopSize();
+  const int ahead = juce::jmax(0, getLatencySamples() - elapsed);
+  return 0x80000000u - (juce::uint32)ahead * increment;
+}
+
+void PitchShifter::rephaseHeads(int sample, juce::uint32 increment) {
+  // 웻 게인이 0인 순간에만 불리므로 딜레이가 바뀌어도 들리지 않습니다.
+  grainPhase += getRephaseTarget(increment) -
+                getHeadPhase(0, sample, increment);
+  spliceOffset.fill(0.0f);
+}
+
+void PitchShifter::applyTransientGain(juce::AudioBuffer<float> &buffer,
+                                      int numChannels, int offset,
+                                      int numSamples) {
+  int i = 0;
+
+  while (i < numSamples && transientStage != TransientStage::idle) {
+    // 페이드 시작 전 구간은 그대로 둡니다.
+    if (transientPosition < 0) {
+      const int wait = juce::jmin(-transientPosition, numSamples - i);
+      transientPosition += wait;
+      i += wait;
+      continue;
+    }
+
+    const int n = juce::jmin(transientFade - transientPosition, numSamples - i);
+    const float start = (float)transientPosition / (float)transientFade;
+    const float end = (float)(transientPosition + n) / (float)transientFade;
+    const bool fadingOut = transientStage == TransientStage::fadingOut;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+      buffer.applyGainRamp(ch, offset + i, n, fadingOut ? 1.0f - start : start,
+                           fadingOut ? 1.0f - end : end);
+
+    transientPosition += n;
+    i += n;
+
+    if (transientPosition == transientFade) {
+      transientStage =
+          fadingOut ? TransientStage::fadingIn : TransientStage::idle;
+      transientPosition = 0;
+    }
+  }
+}
+
+void PitchShifter::alignSplice(int head, int startPos, int sample,
+                               float length, juce::uint32 increment) {
+  if (!spliceAlignment) {
+    spliceOffset[(size_t)head] = 0.0f;
+    return;
+  }
+
+  const auto centre = (float)getLatencySamples();
+
+  auto phaseToDelay = [&](juce::uint32 phase) {
+    const float x = (float)(int)(phase >> 8) * (1.0f / 16777216.0f);
+    return (x - 0.5f) * length + centre;
+  };
+
+  // 기준 헤드: 윈도우 정점(위상 0.5)에 가장 가까운, 가장 크게 들리는 헤드
+  int reference = -1;
+  juce::uint32 bestDistance = 0xffffffffu;
+
+  for (int h = 0; h < numHeads; ++h) {
+    if (h == head)
+      continue;
+
+    const juce::uint32 phase = getHeadPhase(h, sample, increment);
+    const juce::uint32 distance =
+        phase > 0x80000000u ? phase - 0x80000000u : 0x80000000u - phase;
+
+    if (distance < bestDistance) {
+      bestDistance = distance;
+      reference = h;
+    }
+  }
+
+  const int window = juce::jmin(spliceWindow, (int)(length * 0.5f));
+  const int maxLag = juce::jmin(maxSpliceLag, (int)(length * 0.5f));
+
+  if (reference < 0 || window < SimdLanes::width || maxLag < 1) {
+    spliceOffset[(size_t)head] = 0.0f;
+    return;
+  }
+
+  // 두 헤드가 지금까지 읽어 온 직전 구간을 비교합니다 (모두 이미 기록됨).
+  const int now = startPos + sample;
+  const int referenceEnd =
+      now - (int)(phaseToDelay(getHeadPhase(reference, sample, increment)) +
+                  spliceOffset[(size_t)reference]);
+  const int candidateEnd =
+      now - (int)phaseToDelay(getHeadPhase(head, sample, increment));
+
+  const int mask = history.getMask();
+  const float *source = history.getReadPointer(0);
+  float *referenceSegment = spliceScratch.get();
+  float *candidates = referenceSegment + spliceWindow;
+
+  for (int k = 0; k < window; ++k)
+    referenceSegment[k] = source[(referenceEnd - window + k) & mask];
+
+  for (int k = 0; k < window + maxLag; ++k)
+    candidates[k] = source[(candidateEnd - maxLag - window + k) & mask];
+
+  // 지연 lag의 후보 구간은 candidates[maxLag - lag, maxLag - lag + window).
+  // 에너지만 구간을 한 칸씩 옮기며 증분적으로 갱신하고, 상관(내적)은
+  // 지연마다 SIMD 로 새로 계산합니다. 탐색 한 번에 window × (maxLag + 1)
+  // 곱셈 (48 kHz 에서 약 7만 번)이 들지만 헤드 래핑 때만, 청크당 헤드 수
+  // 이하로 일어납니다.
+  float energy = 0.0f;
+  for (int k = 0; k < window; ++k)
+    energy += candidates[maxLag + k] * candidates[maxLag + k];
+
+  int bestLag = 0;
+  float bestScore = -std::numeric_limits<float>::max();
+
+  for (int lag = 0; lag <= maxLag; ++lag) {
+    const int start = maxLag - lag;
+    const float score =
+        SimdLanes::dot(referenceSegment, candidates + start, window) /
+        std::sqrt(juce::jmax(energy, 1.0e-9f));
+
+    if (score > bestScore) {
+      bestScore = score;
+      bestLag = lag;
+    }
+
+    if (start > 0) {
+      const float entering = candidates[start - 1];
+      const float leaving = candidates[start - 1 + window];
+      energy = juce::jmax(0.0f, energy + entering * entering - leaving * leaving);
+    }
+  }
+
+  spliceOffset[(size_t)head] = (float)bestLag;
 }
 
 void PitchShifter::process(juce::AudioBuffer<float> &buffer) {
   // 단순 딜레이 라인 기반 피치 시프터 (Whammy 스타일)
   // 가변 속도 테이프 루프의 단순화된 구현입니다.
-  // 일정한 길이를 유지하려면 쓰기 포인터보다 빠르거나 느리게 움직이는 읽기
-  // 포인터를 처리해야 합니다.
+  //
+  // 기본 구성은 두 개의 읽기 헤드가 윈도우 길이의 절반만큼 떨어져 회전하며
+  // (연구 문서: "버퍼 크기의 절반만큼 떨어진 두 개의 읽기 포인터"),
+  // 삼각형 윈도우로 크로스페이드하여 래핑 지점의 클릭을 숨깁니다.
+  // 헤드를 3/4/8개로 늘리고 Hann/Tukey 윈도우를 쓰면 서스테인이 부드러워집니다.
+  //
+  // 처리는 블록 단위 파이프라인입니다:
+  //   1. 입력 블록 전체를 히스토리에 memcpy로 기록
+  //   2. 헤드별 읽기 인덱스/보간 비율/게인 램프를 위상 누산기로 생성
+  //   3. 모든 채널이 램프를 공유하며 SIMD로 gather & mix
+  // 블록은 chunkSize 단위 청크로 나눠 청크마다 위 단계를 밟습니다.
 
-  // 참고: 진정한 "Whammy" 스타일은 읽기 포인터가 쓰기 포인터를 추월할 때
-  // 클릭음을 방지하기 위해 SOLA와 유사한 기술이나 두 읽기 헤드 간의 단순
-  // 크로스페이딩을 자주 사용합니다.
+  const int numSamples = buffer.getNumSamples();
+  const int numChannels = juce::jmin(buffer.getNumChannels(), numBusChannels);
 
-  // 그 "글리치한" 사운드를 위해 기본적인 듀얼 읽기 헤드 그래뉼러 스타일 접근
-  // 방식을 구현해 봅시다.
+  // 커널은 블록마다 한 번만 고릅니다.
+  const auto kernel = selectKernel(numChannels);
 
-  const int numSamples = buffer.getNumSamples();
-  const int numChannels = buffer.getNumChannels();
+  for (int offset = 0; offset < numSamples; offset += chunkSize)
+    (this->*kernel)(buffer, numChannels, offset,
+                    juce::jmin(chunkSize, numSamples - offset));
+}
+
+bool PitchShifter::keepWarm(const juce::AudioBuffer<float> &input) {
+  // 입력을 히스토리에 memcpy 로 이어 붙이기만 합니다. 헤드 딜레이는 쓰기
+  // 위치 기준이므로 재개하면 바로 최근 입력을 읽습니다.
+  const int numSamples = input.getNumSamples();
+  const int numChannels = juce::jmin(input.getNumChannels(), numBusChannels);
+
+  for (int offset = 0; offset < numSamples; offset += chunkSize) {
+    const int n = juce::jmin(chunkSize, numSamples - offset);
 
-  // 두 채널을 모두 처리합니다. 스테레오 일관성을 위해 두 채널 모두 동일한 읽기
-  // 포인터 로직을 사용해야 합니다. 따라서 인덱스를 한 번 계산하고 모든 채널에
-  // 적용합니다.
+    for (int channel = 0; channel < numChannels; ++channel)
+      history.writeBlock(channel, input.getReadPointer(channel, offset), n);
 
-  auto *channelDataL = buffer.getWritePointer(0);
-  auto *channelDataR = (numChannels > 1) ? buffer.getWritePointer(1) : nullptr;
+    writeVoiceSource(input, numChannels, offset, n);
+    history.advance(n);
+  }
+
+  // 바이패스 중의 어택으로 재위상이 걸려 있지 않게 합니다.
+  transientStage = TransientStage::idle;
+  return true;
+}
+
+// 한 채널 구성/윈도우에 대한 보간 품질별 커널 행
+template <int NumChannels, typename Window>
+constexpr std::array<PitchShifter::ChunkKernel, numInterpolationQualities>
+PitchShifter::makeKernelRow() {
+  return {&PitchShifter::processChunk<NumChannels, Interpolators::Linear, Window>,
+          &PitchShifter::processChunk<NumChannels, Interpolators::Hermite, Window>,
+          &PitchShifter::processChunk<NumChannels, Interpolators::Lagrange<4>,
+                                      Window>,
+          &PitchShifter::processChunk<NumChannels, Interpolators::Lagrange<6>,
+                                      Window>,
+          &PitchShifter::processChunk<NumChannels, Interpolators::Sinc, Window>};
+}
+
+PitchShifter::ChunkKernel PitchShifter::selectKernel(int numChannels) const {
+  using GrainWindows::Hann;
+  using GrainWindows::Tabulated;
+  using GrainWindows::Triangle;
+  using KernelRow = std::array<ChunkKernel, numInterpolationQualities>;
+
+  // [윈도우 정책][채널 구성][보간 품질]
+  static constexpr std::array<std::array<KernelRow, 3>, 3> table{
+      {{makeKernelRow<1, Triangle>(), makeKernelRow<2, Triangle>(),
+        makeKernelRow<0, Triangle>()},
+       {makeKernelRow<1, Hann>(), makeKernelRow<2, Hann>(),
+        makeKernelRow<0, Hann>()},
+       {makeKernelRow<1, Tabulated>(), makeKernelRow<2, Tabulated>(),
+        makeKernelRow<0, Tabulated>()}}};
+
+  // 삼각형(짝수 헤드)과 Hann 은 해석적으로, 나머지는 테이블로 계산합니다.
+  const bool analytic =
+      GrainWindows::analyticScale(windowShape, numHeads) > 0.0f;
+  const int windowPolicy =
+      !analytic ? 2 : (windowShape == WindowShape::hann ? 1 : 0);
+  const int channelClass = numChannels == 1 ? 0 : (numChannels == 2 ? 1 : 2);
+
+  return table[(size_t)windowPolicy][(size_t)channelClass]
+              [(size_t)interpolationQuality];
+}
+
+template <int NumChannels, typename Interpolator, typename Window>
+void PitchShifter::processChunk(juce::AudioBuffer<float> &buffer,
+                                int numChannels, int offset, int numSamples) {
+  const int startPos = history.getWritePosition();
+  const int paddedSamples = padToWidth(numSamples);
+
+  // 1. 원형 버퍼에 입력 블록 쓰기
+  // 읽기 위치는 항상 해당 샘플의 쓰기 위치 이전이므로 먼저 써도 안전합니다.
+  for (int channel = 0; channel < numChannels; ++channel)
+    history.writeBlock(channel, buffer.getReadPointer(channel, offset),
+                       numSamples);
+
+  writeVoiceSource(buffer, numChannels, offset, numSamples);
+
+  // 2. 헤드별 램프 생성 (채널 간 공유)
+  // 그레인 길이는 청크 안에서 선형으로 움직이고, 위상 증가량은
+  // 청크 시작 시점의 길이로 한 번만 계산합니다.
+  const float length = grainLength.getCurrentValue();
+  const float lengthStep =
+      (grainLength.skip(numSamples) - length) / (float)numSamples;
+  const juce::uint32 increment =
+      preparePitchSweep(length, numSamples, paddedSamples);
+  const juce::uint32 *phaseOffsets = sweeping ? sweepPhase.get() : nullptr;
+
+  // 어택 검출: 진행 중인 재위상이 없을 때만 새 페이드를 시작합니다.
+  // 페이드아웃이 끝나는 지점(rephaseAt)에서 헤드 위상을 옮깁니다.
+  if (onsetDetector.isEnabled()) {
+    const int onset = onsetDetector.process(
+        buffer.getReadPointer(0, offset),
+        numChannels > 1 ? buffer.getReadPointer(1, offset) : nullptr,
+        numSamples);
+
+    if (onset >= 0 && transientStage == TransientStage::idle) {
+      transientStage = TransientStage::fadingOut;
+      transientPosition = -onset;
+    }
+  }
+
+  const int rephaseAt = transientStage == TransientStage::fadingOut
+                            ? transientFade - transientPosition
+                            : -1;
+
+  // 스플라이스 정렬 중이거나 남은 오프셋이 있으면 청크를 헤드 래핑 지점에서
+  // 나눠, 래핑마다 새 그레인의 오프셋을 정한 뒤 이어서 램프를 만듭니다.
+  const bool trackWraps =
+      spliceAlignment ||
+      std::any_of(spliceOffset.begin(), spliceOffset.end(),
+                  [](float o) { return !juce::exactlyEqual(o, 0.0f); });
+  int searchesLeft = numHeads;
+  int from = 0;
+
+  while (from < numSamples) {
+    int to = numSamples;
+    int wrappingHead = -1;
+
+    if (trackWraps) {
+      for (int head = 0; head < numHeads; ++head) {
+        const int wrap = samplesUntilWrap(head, from, increment);
+
+        if (wrap <= to - from) {
+          to = from + wrap;
+          wrappingHead = head;
+        }
+      }
+    }
+
+    if (rephaseAt > from && rephaseAt < to) {
+      to = rephaseAt;
+      wrappingHead = -1;
+    }
+
+    const int end = to == numSamples ? paddedSamples : to;
+
+    for (int head = 0; head < numHeads; ++head)
+      generateRamps<Window>(head, getHeadPhase(head, 0, increment),
+                            spliceOffset[(size_t)head], startPos, from, end,
+                            length, lengthStep, increment, phaseOffsets);
+
+    if (to == rephaseAt)
+      rephaseHeads(to, increment);
+    else if (wrappingHead >= 0 && searchesLeft-- > 0)
+      alignSplice(wrappingHead, startPos, to, length + (float)to * lengthStep,
+                  increment);
+
+    from = to;
+  }
+
+  // 3. gather & mix 후 출력으로 복사
+  // 주 보이스 헤드를 믹스 행에 쓴 뒤, 하모니 보이스를 헤드 행이 차는
+  // 만큼씩 묶어 램프를 다시 채우고 믹스 행에 더합니다. 모노/스테레오는
+  // 한 패스에서 램프를 공유하고, 그 외 채널 수는 모노 커널을 채널마다
+  // 반복합니다. 보이스는 voiceChannel 한 채널만 읽어 팬으로 나눕니다.
+  constexpr int passChannels = NumChannels == 0 ? 1 : NumChannels;
+  for (int first = 0; first < numChannels; first += passChannels) {
+    const float *sources[(size_t)passChannels];
+    float *mix[(size_t)passChannels];
+
+    for (int c = 0; c < passChannels; ++c) {
+      sources[c] = history.getReadPointer(first + c);
+      mix[c] = ramps.getChannelPointer((size_t)(mixRow + first + c));
+    }
+
+    renderChannels<passChannels, Interpolator>(sources, mix, paddedSamples);
+  }
+
+  const int voicesPerPass = maxGrainHeads / numHeads;
+  for (int first = 0; first < numHarmonyVoices; first += voicesPerPass) {
+    const int numVoices = juce::jmin(voicesPerPass, numHarmonyVoices - first);
+    const float *gains[(size_t)(maxVoicesPerPass * passChannels)];
+
+    for (int v = 0; v < numVoices; ++v) {
+      generateVoiceRamps<Window>(first + v, v * numHeads, startPos, numSamples,
+                                 paddedSamples, length, lengthStep, rephaseAt);
+      generateVoiceGains(first + v, voiceGainRow + v * passChannels,
+                         passChannels, numSamples, paddedSamples);
+
+      for (int c = 0; c < passChannels; ++c)
+        gains[v * passChannels + c] = ramps.getChannelPointer(
+            (size_t)(voiceGainRow + v * passChannels + c));
+    }
+
+    for (int channel = 0; channel < numChannels; channel += passChannels) {
+      float *mix[(size_t)passChannels];
+      for (int c = 0; c < passChannels; ++c)
+        mix[c] = ramps.getChannelPointer((size_t)(mixRow + channel + c));
+
+      renderVoices<passChannels, Interpolator>(
+          history.getReadPointer(voiceChannel), mix, gains, numVoices,
+          paddedSamples);
+    }
+  }
+
+  for (int channel = 0; channel < numChannels; ++channel)
+    juce::FloatVectorOperations::copy(
+        buffer.getWritePointer(channel, offset),
+        ramps.getChannelPointer((size_t)(mixRow + channel)), numSamples);
+
+  if (transientStage != TransientStage::idle)
+    applyTransientGain(buffer, numChannels, offset, numSamples);
+
+  // 쓰기 포인터와 위상 전진
+  history.advance(numSamples);
+  grainPhase += sweeping ? sweepPhase[numSamples]
+                        : increment * (juce::uint32)numSamples;
 
-  // 딜레이 버퍼 포인터
-  auto *delayDataL = delayBuffer.getWritePointer(0);
-  auto *delayDataR =
-      (numChannels > 1) ? delayBuffer.getWritePointer(1) : nullptr;
+  for (int v = 0; v < numHarmonyVoices; ++v) {
+    auto &voice = harmonyVoices[(size_t)v];
+    voice.phase += getPhaseIncrement(length, voice.ratio) * (juce::uint32)numSamples;
+  }
+
+  releaseSilentVoices();
+}
+
+template <typename Window>
+void PitchShifter::generateRamps(int row, juce::uint32 headPhase,
+                                 float delayOffset, int startPos, int from,
+                                 int to, float length, float lengthStep,
+                                 juce::uint32 increment,
+                                 const juce::uint32 *phaseOffsets) {
+  // 위상은 샘플마다 일정한 양(increment)만큼 증가하며, 루프는 분기 없이
+  // 벡터화됩니다. 음정 램프 중이면 미리 누적해 둔 phaseOffsets[i] 를 대신 더합니다.
+  // headPhase 는 청크 첫 샘플 기준 위상입니다.
+  // 딜레이는 레이턴시(상한의 반 그레인 + 보간 여유분)를 중심으로
+  // 현재 그레인 길이만큼 퍼지므로 길이가 바뀌어도 중심은 그대로입니다.
+  const int mask = history.getMask();
+  const float offset = (float)getLatencySamples() + delayOffset;
+
+  auto *frac = ramps.getChannelPointer((size_t)(row * 2));
+  auto *gain = ramps.getChannelPointer((size_t)(row * 2 + 1));
+  int *index = readIndex.get() + row * padToWidth(chunkSize);
+
+  const auto *table = windowTable;
+  const float scale = windowScale;
+
+  auto ramp = [&](int i, juce::uint32 phase) {
+    // 상위 24비트만 사용하면 float 변환이 정확하고 벡터화됩니다.
+    const float x = (float)(int)(phase >> 8) * (1.0f / 16777216.0f);
+    const float windowLen = length + (float)i * lengthStep;
+    const float delay = (x - 0.5f) * windowLen + offset;
+    const int di = (int)delay;
+
+    // 읽기 위치 = (startPos + i) - delay 를 i0 + t 로 분해합니다.
+    // 인덱스는 가장 긴 커널의 첫 탭(i0 - maxFirstTap)을 가리키며,
+    // 나머지 탭은 가드 꼬리 안에 있으므로 래핑 검사가 필요 없습니다.
+    index[i] = (startPos + i - di - 1 - Interpolators::maxFirstTap) & mask;
+    frac[i] = 1.0f - (delay - (float)di);
+    // 테이블 윈도우 게인은 아래 별도 패스에서 구합니다.
+    gain[i] = Window::tabulated ? x : Window::gain(x, table) * scale;
+  };
+
+  if (phaseOffsets != nullptr) {
+    for (int i = from; i < to; ++i)
+      ramp(i, headPhase + phaseOffsets[i]);
+  } else {
+    // i * increment 는 SSE2 에 32비트 벡터 곱이 없어 에뮬레이션되므로,
+    // 위상을 귀납 변수로 더해 가며 구합니다 (램프 비용이 약 절반).
+    juce::uint32 phase = headPhase + (juce::uint32)from * increment;
+
+    for (int i = from; i < to; ++i) {
+      ramp(i, phase);
+      phase += increment;
+    }
+  }
+
+  // 테이블 윈도우는 샘플마다 흩어진 위치를 읽으므로(gather) 위 루프에 두면
+  // 루프 전체가 스칼라로 떨어집니다. 위상만 먼저 벡터 루프로 구해 두고
+  // 테이블 읽기를 따로 돌리면 헤드당 비용이 약 1/3 줄어듭니다.
+  // 해석적 윈도우는 위 루프 안에서 그대로 벡터화됩니다.
+  if constexpr (Window::tabulated)
+    for (int i = from; i < to; ++i)
+      gain[i] = Window::gain(gain[i], table);
+}
+
+template <typename Window>
+void PitchShifter::generateVoiceRamps(int voice, int firstRow, int startPos,
+                                      int numSamples, int paddedSamples,
+                                      float length, float lengthStep,
+                                      int rephaseAt) {
+  // 보이스의 헤드는 주 보이스 헤드가 쓰던 램프 행을 firstRow 부터
+  // 다시 채웁니다.
+  auto &v = harmonyVoices[(size_t)voice];
+  const juce::uint32 increment = getPhaseIncrement(length, v.ratio);
+
+  // 주 보이스와 같은 지점에서 어택 재위상을 적용합니다.
+  int from = 0;
+  while (from < numSamples) {
+    const int to =
+        rephaseAt > from && rephaseAt < numSamples ? rephaseAt : numSamples;
+    const int end = to == numSamples ? paddedSamples : to;
+
+    for (int head = 0; head < numHeads; ++head)
+      generateRamps<Window>(firstRow + head, v.phase + getHeadOffset(head),
+                            0.0f,
+                            startPos, from, end, length, lengthStep, increment,
+                            nullptr);
+
+    if (to == rephaseAt)
+      v.phase += getRephaseTarget(increment) -
+                 (v.phase + (juce::uint32)to * increment);
+
+    from = to;
+  }
+}
+
+template <int NumChannels, typename Interpolator>
+forcedinline void PitchShifter::readHead(const float *const *sources, int row, int i,
+                            SimdLanes::Lanes *out) const {
+  using SimdLanes::Lanes;
+  constexpr int width = SimdLanes::width;
+  constexpr int numTaps = Interpolator::numTaps;
+  constexpr int tapOffset = Interpolators::maxFirstTap - Interpolator::firstTap;
+
+  // 채널들은 같은 읽기 인덱스를 쓰므로 인덱스는 한 번만 읽어 모든
+  // 채널의 탭을 함께 모읍니다.
+  const int *index = readIndex.get() + row * padToWidth(chunkSize) + i;
+  const auto *frac = ramps.getChannelPointer((size_t)(row * 2)) + i;
+  const auto gain =
+      SimdLanes::load(ramps.getChannelPointer((size_t)(row * 2 + 1)) + i);
+
+  // 히스토리에서 탭을 모은 뒤(gather) 레지스터에서 보간 및 게인 적용
+  alignas(SimdLanes::alignment)
+      float taps[(size_t)NumChannels][(size_t)numTaps][(size_t)width];
+
+  for (int k = 0; k < width; ++k) {
+    const int first = index[k] + tapOffset;
+
+    for (int c = 0; c < NumChannels; ++c)
+      for (int j = 0; j < numTaps; ++j)
+        taps[c][j][k] = sources[c][first + j];
+  }
 
-  for (int i = 0; i < numSamples; ++i) {
-    // 1. 원형 버퍼에 입력 쓰기
-    float inL = channelDataL[i];
-    float inR = (channelDataR != nullptr) ? channelDataR[i] : inL;
+  for (int c = 0; c < NumChannels; ++c) {
+    Lanes x[(size_t)numTaps];
+    for (int j = 0; j < numTaps; ++j)
+      x[j] = SimdLanes::load(taps[c][j]);
+
+    out[c] = gain * Interpolator::interpolate(x, frac);
+  }
+}
+
+template <int NumChannels, typename Interpolator>
+void PitchShifter::renderChannels(const float *const *sources,
+                                  float *const *dests, int numSamples) {
+  using SimdLanes::Lanes;
+
+  // SIMD 레인은 헤드가 아니라 연속된 샘플입니다. 헤드를 레인에 묶는
+  // 구성(샘플마다 헤드 4개를 한 레지스터로)도 시험했지만, 비용 대부분이
+  // 헤드마다 히스토리의 다른 위치를 읽는 탭 gather 라 레인 배치와 무관하게
+  // 헤드 수에 비례했고, 샘플 단위 루프와 수평 합 때문에 오히려 느렸습니다.
+  // 그래서 헤드(와 보이스)는 행으로 두고 비용은 헤드 수에 선형입니다.
+  // 헤드마다 탭 위치가 달라 탭을 헤드끼리 나눠 쓸 수도 없으므로, 헤드당
+  // 고정 비용(램프, 윈도우, 인덱스 읽기)을 줄이는 쪽으로 다듬었습니다.
+  for (int i = 0; i < numSamples; i += SimdLanes::width) {
+    Lanes acc[(size_t)NumChannels];
+    Lanes head[(size_t)NumChannels];
+    for (int c = 0; c < NumChannels; ++c)
+      acc[c] = SimdLanes::expand(0.0f);
+
+    for (int row = 0; row < numHeads; ++row) {
+      readHead<NumChannels, Interpolator>(sources, row, i, head);
+      for (int c = 0; c < NumChannels; ++c)
+        acc[c] += head[c];
+    }
+
+    for (int c = 0; c < NumChannels; ++c)
+      SimdLanes::store(acc[c], dests[c] + i);
+  }
+}
 
-    delayDataL[writePos] = inL;
-    if (delayDataR)
-      delayDataR[writePos] = inR;
-
-    // 2. 크로스페이딩으로 원형 버퍼에서 읽기
-    // 윈도우 방식을 사용합니다.
-    // 이상적으로는 읽기 포인터가 'pitchRatio' 속도로 움직이기를 원합니다.
-    // 상대 속도 = pitchRatio - 1.0
-    // pitchRatio = 1이면 readPos는 1.0(쓰기와 동일)으로 이동하고 거리는
-    // 일정하게 유지됩니다. 잠깐, 타임 스트레칭 없는 실시간 피치 시프팅의 경우
-    // 단순히 리샘플링합니다. 하지만 타이밍을 동일하게 유지하려면 주기적으로
-    // 읽기 포인터를 재설정해야 합니다.
-
-    // 윈도우 처리를 위해 간단한 페이저 접근 방식을 사용해 봅시다.
-    // 이것은 효과적으로 2개의 그레인을 사용하는 그래뉼러 접근 방식입니다.
-
-    // 사실, 연구 문서에 설명된 로직을 구현해 봅시다:
-    // 두 개의 읽기 포인터, 크로스페이딩.
-
-    // 첫 번째 패스에서의 단순성을 위해 기본 회전 테이프 헤드 모델을 시도해
-    // 봅시다. 이것은 종종 "회전 테이프 헤드" 또는 "윈도우 딜레이"라고 불립니다.
-
-    // 쓰기 위치에 대한 읽기 위치 계산
-    // 딜레이가 변하기를 원합니다.
-    // delay(t) = delay(t-1) + (1 - pitchRatio)
-
-    // 더 간단한 로직을 사용해 봅시다:
-    // 0에서 1로 가는 '위상'이 있습니다.
-    // 읽기 포인터 1은 위상에 있습니다.
-    // 읽기 포인터 2는 위상 + 0.5(래핑됨)에 있습니다.
-    // 위상에 대한 삼각형 윈도우를 기반으로 크로스페이드합니다.
-
-    // 주파수 차이에 따라 위상 증가
-    // 비율 = (1 - pitchRatio) * 주파수 / 샘플 레이트?
-    // 아니요, 딜레이 변조로 봅시다.
-
-    // 가능하다면 "Whammy" 특정 로직을 고수합시다.
-    // 연구 문서 언급: "버퍼 크기의 절반만큼 떨어진 두 개의 읽기 포인터".
-
-    // "윈도우 크기"(예: 50ms)를 정의해 봅시다.
-    // 이 윈도우를 통해 이동합니다.
-
-    // 유효 로직:
-    // 델타 = 1.0 - pitchRatio;
-    // readPos += 델타;
-
-    // readPos가 너무 멀어지면 윈도우 크기 주위로 래핑합니다.
-
-    // 구현해 봅시다:
-    // 'delay' 변수를 유지합니다.
-    // delay += (1.0 - pitchRatio);
-    // delay < 0 또는 delay > maxDelay이면 래핑해야 합니다.
-    // 클릭음을 피하기 위해 두 개의 탭을 사용합니다.
-
-    // 윈도우 처리를 위해 전역 '페이저'를 사용해 봅시다.
-    // 페이저는 (1.0 - pitchRatio) / windowSize 만큼 증가합니다.
-
-    float relativeSpeed = 1.0f - pitchRatio;
-
-    // 쓰기 포인터에 대해 읽기 포인터를 전진시켜야 합니다.
-    // readPos는 샘플 단위의 딜레이입니다.
-    readPos += relativeSpeed;
-
-    // 윈도우 내에서 readPos 래핑
-    // 윈도우가 2048 샘플이라고 가정해 봅시다.
-    float windowLen = 2048.0f;
-
-    // 'readPos'가 딜레이 양이 되기를 원합니다.
-    // 이 딜레이를 원형 버퍼의 위치에 매핑합니다.
-    // 실제 읽기 인덱스 = writePos - readPos
-
-    // 래핑을 부드럽게 처리하기 위해 두 개의 탭을 사용합니다.
-    // 탭 1: 딜레이 = readPos (모듈로 windowLen)
-    // 탭 2: 딜레이 = readPos + windowLen/2 (모듈로 windowLen)
-
-    // 잠깐, 더 좋은 방법은:
-    // 그레인 윈도우 내의 위치를 나타내는 메인 "페이저" 0..1이 있습니다. 이
-    // 페이저의 속도는 피치 시프트 양에 의해 결정됩니다. 속도 = (pitchRatio
-    // - 1.0) * 샘플 레이트 / 윈도우 크기? 사실, 속도 = (1.0 - pitchRatio) /
-    // 윈도우 크기 * 샘플 레이트는 정확하지 않습니다. 버퍼 순회 속도는
-    // pitchRatio입니다. 쓰기 속도는 1.0입니다. 차이는 (1.0 - pitchRatio)입니다.
-    // 따라서 샘플당 (1.0 - pitchRatio) 샘플을 누적합니다.
-
-    // 이것을 'delayWalk'라고 부릅시다.
-    // delayWalk += (1.0 - pitchRatio);
-
-    // delayWalk를 [0, windowLen]으로 래핑합니다.
-    // 하지만 단순히 래핑하면 클릭음이 발생합니다.
-    // 그래서 삼각형 윈도우를 사용합니다.
-
-    // 탭 1 딜레이: delayWalk
-    // 탭 2 딜레이: delayWalk + windowLen/2 (래핑됨)
-
-    // 게인 1: 딜레이가 windowLen/2일 때 피크인 삼각형 윈도우?
-    // 보통:
-    // 딜레이가 0이면 쓰기 포인터에 있습니다(레이턴시 0).
-    // 딜레이가 windowLen이면 훨씬 뒤에 있습니다.
-    // 가장자리(0과 windowLen)에서는 페이드 아웃하고 중앙에서는 페이드 인하기를
-    // 원합니다.
-
-    while (readPos < 0)
-      readPos += windowLen;
-    while (readPos >= windowLen)
-      readPos -= windowLen;
-
-    float delay1 = readPos;
-    float delay2 = readPos + windowLen * 0.5f;
-    if (delay2 >= windowLen)
-      delay2 -= windowLen;
-
-    // 게인 계산 (삼각형 윈도우)
-    // 0 -> 0, windowLen/2 -> 1, windowLen -> 0
-    auto getGain = [&](float d) {
-      float x = d / windowLen; // 0..1
-      if (x < 0.5f)
-        return x * 2.0f;
-      else
-        return (1.0f - x) * 2.0f;
-    };
-
-    float gain1 = getGain(delay1);
-    float gain2 = getGain(delay2);
-
-    // 버퍼에서 읽기
-    auto getSample = [&](float delay, int channel) {
-      float rPos = (float)writePos - delay;
-      while (rPos < 0)
-        rPos += bufferSize;
-      while (rPos >= bufferSize)
-        rPos -= bufferSize;
-
-      int i0 = (int)rPos;
-      int i1 = (i0 + 1) % bufferSize;
-      float frac = rPos - i0;
-
-      float *d = (channel == 0) ? delayDataL : delayDataR;
-      return d[i0] + frac * (d[i1] - d[i0]); // 선형 보간
-    };
-
-    float outL = getSample(delay1, 0) * gain1 + getSample(delay2, 0) * gain2;
-    float outR =
-        (numChannels > 1)
-            ? (getSample(delay1, 1) * gain1 + getSample(delay2, 1) * gain2)
-            : outL;
-
-    // 게인 정규화?
-    // 0.5만큼 오프셋된 삼각형 윈도우의 게인 합은 상수 1.0인가요?
-    // 확인해 봅시다:
-    // x가 0..0.5일 때: g1 = 2x.
-    // x2 = x + 0.5 (0.5..1 범위). g2 = (1 - (x+0.5))*2 = (0.5 - x)*2 = 1 - 2x.
-    // g1 + g2 = 2x + 1 - 2x = 1.
-    // 네, 합이 일정합니다.
-
-    channelDataL[i] = outL;
-    if (channelDataR)
-      channelDataR[i] = outR;
-
-    // 쓰기 포인터 전진
-    writePos++;
-    if (writePos >= bufferSize)
-      writePos = 0;
+template <int NumPans, typename Interpolator>
+void PitchShifter::renderVoices(const float *source, float *const *dests,
+                                const float *const *gains, int numVoices,
+                                int numSamples) {
+  using SimdLanes::Lanes;
+
+  // 보이스 헤드는 채널마다가 아니라 한 번만 gather 하고, 보이스마다 헤드
+  // 합에 팬 게인을 한 번 곱해 채널로 나눕니다. 스테레오에서 보이스 하나의
+  // 탭 읽기와 보간이 주 보이스의 절반입니다.
+  for (int i = 0; i < numSamples; i += SimdLanes::width) {
+    Lanes acc[(size_t)NumPans];
+    for (int c = 0; c < NumPans; ++c)
+      acc[c] = SimdLanes::load(dests[c] + i);
+
+    for (int voice = 0; voice < numVoices; ++voice) {
+      Lanes sum = SimdLanes::expand(0.0f);
+      Lanes head;
+
+      for (int row = voice * numHeads; row < (voice + 1) * numHeads; ++row) {
+        readHead<1, Interpolator>(&source, row, i, &head);
+        sum += head;
+      }
+
+      for (int c = 0; c < NumPans; ++c)
+        acc[c] += sum * SimdLanes::load(gains[voice * NumPans + c] + i);
+    }
+
+    for (int c = 0; c < NumPans; ++c)
+      SimdLanes::store(acc[c], dests[c] + i);
   }
 }
@@ -1,33 +1,261 @@
 #pragma once
 
+#include "GrainWindows.h"
+#include "Interpolators.h"
+#include "OnsetDetector.h"
+#include "PitchEngine.h"
+#include "PitchRamp.h"
+#include "RingBuffer.h"
 #include <JuceHeader.h>
 
-class PitchShifter {
+class PitchShifter : public PitchEngine {
 public:
   PitchShifter();
-  ~PitchShifter();
+  ~PitchShifter() override;
 
-  void prepare(double sampleRate, int samplesPerBlock);
-  void reset();
-  void setPitch(float semitones);
-  void process(juce::AudioBuffer<float> &buffer);
+  void prepare(double sampleRate, int samplesPerBlock,
+               int numChannels) override;
+  void reset() override;
+  using PitchEngine::setPitch;
+  void setPitch(float semitones, int rampSamples) override;
+  void setInterpolationQuality(InterpolationQuality quality);
+  void setGrainHeads(int requestedHeads);
+  void setWindowShape(WindowShape shape);
+  // 그레인 길이는 상한 안에서 목표로 램프합니다. 상한을 바꾸면 헤드 중심이
+  // 한 번에 옮겨지므로 엔진을 비울 때(레이턴시 모드 전환)만 바꿉니다.
+  void setGrainLength(float milliseconds);
+  void setGrainLengthLimit(float milliseconds);
+  void setAdaptiveGrain(bool shouldAdapt);
+  void setDetectedPeriod(float periodSamples, float confidence);
+  void setSpliceAlignment(bool shouldAlign);
+  void setTransientSensitivity(float sensitivity);
+  void process(juce::AudioBuffer<float> &buffer) override;
+  bool keepWarm(const juce::AudioBuffer<float> &input) override;
+
+  // 하모니 보이스: 원음 대비 고정 음정으로 시프트한 보이스를 주 출력에
+  // 더합니다. 모든 보이스는 같은 히스토리와 그레인 길이를 공유하고,
+  // 스테레오 버스에서는 좌우 평균을 시프트해 pan 으로 나눕니다.
+  // pan 은 -1(왼쪽) .. 1(오른쪽) 밸런스, level 은 선형 게인입니다.
+  void setHarmonyVoiceCount(int count);
+  void setHarmonyVoice(int voice, float semitones, float level, float pan);
+
+  // 켤 수 있는 하모니 보이스 수의 상한 (prepare 전에 호출). 보이스용 게인
+  // 행과 mid 히스토리 채널은 용량이 있을 때만 할당하므로, 보이스를 쓰지
+  // 않는 소유자는 0 으로 두어 메모리를 아낍니다.
+  void setHarmonyCapacity(int maxVoices);
+
+  // prepare 에서 할당한 히스토리 용량 (채널당 샘플, 2의 거듭제곱)과
+  // 히스토리, 블록 램프, 읽기 인덱스를 합친 바이트 수
+  int getHistoryCapacity() const { return history.getCapacity(); }
+  size_t getFootprintBytes() const;
+
+  // 엔진이 원음 대비 지연시키는 샘플 수 (그레인 윈도우의 중심)
+  // 보간 품질과 무관하게 일정하도록 커널 여유분을 포함합니다.
+  // 헤드 딜레이를 그레인 길이 상한의 반에 중심을 두므로 레이턴시는 상한을
+  // 바꿀 때만 달라집니다. 프로세서는 상한을 레이턴시 모드로만 정하고
+  // (Low 8 ms, High Quality maxGrainMs), GRAIN 은 그 안에서 길이만 램프합니다.
+  int getLatencySamples() const override {
+    return grainLengthLimit / 2 + Interpolators::maxLookahead;
+  }
+
+  int getMaxLatencySamples() const override {
+    return maxGrainLength / 2 + Interpolators::maxLookahead;
+  }
+
+  // 헤드가 읽는 가장 먼 과거: 최대 그레인 길이 + 스플라이스 오프셋 + 보간 탭
+  int getTailSamples() const override {
+    return maxGrainLength + maxSpliceLag + Interpolators::maxLookahead +
+           Interpolators::maxFirstTap + 1;
+  }
+
+  // 그레인 길이 범위 (밀리초)
+  static constexpr float minGrainMs = 5.0f;
+  static constexpr float maxGrainMs = 100.0f;
+
+  static constexpr int maxHarmonyVoices = 8;
+
+  // 블록은 최대 maxChunkSize 샘플의 청크로 나눠 처리합니다. 헤드 램프 행과
+  // 읽기 인덱스가 청크 크기로 잡히므로 호스트 블록이 커도 메모리가 늘지
+  // 않고, 한 청크의 행 전체(보이스 포함)가 캐시에 머뭅니다.
+  static constexpr int maxChunkSize = 128;
 
 private:
   double sampleRate = 44100.0;
+  int chunkSize = 0; // min(prepare 의 블록 크기, maxChunkSize)
+
+  // 원형 버퍼 (2의 거듭제곱 용량 + 보간용 가드 꼬리)
+  // 다채널 버스에서 하모니 보이스를 쓰면 버스 채널 뒤에 앞 두 채널의
+  // 평균(mid) 채널을 하나 더 둡니다. 보이스는 이 한 채널만 읽고 팬으로
+  // 채널에 나누므로, 보이스 헤드의 탭 gather 를 채널끼리 공유합니다.
+  RingBuffer history;
+  static constexpr int historyGuard = 8;
+  int numBusChannels = 1;
+  int voiceChannel = 0; // 보이스가 읽는 히스토리 채널 (모노 버스면 0)
 
-  // 원형 버퍼 파라미터
-  juce::AudioBuffer<float> delayBuffer;
-  int writePos = 0;
-  float readPos = 0.0f;
-  int bufferSize = 0;
+  // 그레인 위상 (32비트 고정 소수점, 2^32 = 윈도우 한 바퀴)
+  // 부호 없는 오버플로로 래핑되므로 분기 없이 순환합니다.
+  juce::uint32 grainPhase = 0;
 
   // 피치 시프팅 파라미터
-  float currentPitch = 0.0f;
-  float pitchRatio = 1.0f;
+  // 음정은 setPitch 가 정한 반음 단위 램프를 샘플마다 따라가, 블록 경계에서
+  // 비율이 계단처럼 바뀌지 않게 합니다. 램프 중인 청크는 샘플별 비율을
+  // 블록 exp2 로 한 번에 구하고, 위상 증가량을 누적해 sweepPhase 에 둡니다.
+  PitchRamp pitch;
+  juce::HeapBlock<juce::uint32> sweepPhase; // 청크 시작 기준 주 보이스 위상
+  bool sweeping = false;
+  int sweepLength = 0;
+  InterpolationQuality interpolationQuality = InterpolationQuality::linear;
+
+  // 그레인 길이 (샘플). 레이턴시 대 부드러움 조절.
+  // 바뀌면 딜레이가 튀지 않도록 목표 길이로 선형 램프합니다.
+  // 상한(grainLengthLimit, 짝수)은 레이턴시를 정하고, 히스토리는
+  // 어떤 상한이든 담을 수 있는 maxGrainLength 기준으로 잡습니다.
+  float grainLengthMs = 45.0f;
+  float grainLengthLimitMs = maxGrainMs;
+  int grainLengthLimit = 0;
+  int maxGrainLength = 0;
+  juce::SmoothedValue<float> grainLength{2048.0f};
+  static constexpr double grainLengthRampSeconds = 0.5;
+
+  // 적응형 그레인: 검출된 입력 주기의 정수배를 그레인 길이로 씁니다.
+  // 신뢰도가 낮은 구간에서는 마지막으로 확실했던 길이를 유지합니다.
+  // 길이는 레이턴시 모드가 정한 상한 안에서만 램프하고 헤드 중심은 상한에
+  // 고정이므로, 적응형 그레인은 음색만 바꾸고 레이턴시는 바꾸지 않습니다.
+  bool adaptiveGrain = false;
+  float adaptiveLength = 0.0f; // 0 = 아직 검출된 주기 없음
+  static constexpr float minPeriodConfidence = 0.8f;
+  static constexpr int minGrainPeriods = 3;
+
+  // 겹치는 읽기 헤드 수와 윈도우 형태
+  int numHeads = 2;
+  WindowShape windowShape = WindowShape::triangle;
+  const float *windowTable = nullptr;
+  float windowScale = 1.0f; // 해석적 윈도우의 정규화 배율 (테이블이면 1)
+
+  // 스플라이스 정렬 (SOLA-lite)
+  // 헤드가 래핑되어 새 그레인을 시작할 때, 가장 크게 들리는 다른 헤드와
+  // 정규화 상호상관이 최대가 되는 추가 딜레이를 찾아 그 그레인 동안
+  // 유지합니다. 탐색 비용은 청크당 헤드 수만큼의 탐색으로 제한됩니다.
+  bool spliceAlignment = false;
+  std::array<float, maxGrainHeads> spliceOffset{};
+  int spliceWindow = 0;
+  int maxSpliceLag = 0;
+  juce::HeapBlock<float> spliceScratch;
+  static constexpr double spliceWindowSeconds = 0.003;
+  static constexpr double spliceLagSeconds = 0.01;
+
+  // 어택 재위상: 어택이 검출되면 웻 출력을 잠깐 내렸다가, 0이 된 순간
+  // 헤드 위상을 옮기고 다시 올립니다. 헤드 0 은 어택 샘플을 정확히
+  // 레이턴시만큼 뒤에 윈도우 정점(위상 0.5)에서 읽게 되고,
+  // 다른 헤드는 그때 게인 0 이라 어택이 한 번만, 최대 게인으로 나옵니다.
+  enum class TransientStage { idle, fadingOut, fadingIn };
+  OnsetDetector onsetDetector;
+  TransientStage transientStage = TransientStage::idle;
+  int transientPosition = 0; // 음수면 페이드 시작까지 남은 샘플
+  int transientFade = 0;
+  static constexpr double transientFadeSeconds = 0.00075;
+
+  // 하모니 보이스별 상태. 위상 누산기는 주 보이스(grainPhase)와 같은
+  // 형식이며, 스플라이스 정렬은 주 보이스에만 적용됩니다.
+  // 레벨과 팬은 샘플마다 램프하고, 보이스를 끄면 레벨을 0 까지 내린 뒤
+  // 렌더링에서 뺍니다. 새로 켜는 보이스는 주 보이스 위상에서 0 부터 올라옵니다.
+  struct HarmonyVoice {
+    float ratio = 1.0f;
+    float level = 0.0f;
+    bool enabled = false;
+    juce::SmoothedValue<float> gain;                   // 꺼져 있으면 목표 0
+    std::array<juce::SmoothedValue<float>, 2> balance; // 스테레오 패스 채널별
+    juce::uint32 phase = 0;
+  };
+
+  std::array<HarmonyVoice, maxHarmonyVoices> harmonyVoices;
+  int harmonyCapacity = maxHarmonyVoices;
+  int harmonyVoiceCount = 0; // 켜진 보이스 수
+  int numHarmonyVoices = 0;  // 렌더링하는 보이스 수 (페이드아웃 중 포함)
+  static constexpr double voiceGainRampSeconds = 0.02;
+
+  // 청크 처리용 램프 (헤드별 보간 비율과 게인, 채널별 믹스 누산 결과)
+  // 헤드 행은 주 보이스와 하모니 보이스 묶음이 차례로 다시 채워 쓰므로
+  // 보이스 수와 무관하게 최대 헤드 수만큼만, 믹스 행은 채널 수만큼
+  // prepare 에서 SIMD 정렬로 한 번만 할당합니다. 하모니 보이스는 헤드 행을
+  // 채우는 만큼(maxGrainHeads / numHeads 개)씩 한 패스로 렌더링합니다.
+  // 헤드 행 뒤의 행 위치는 채널 수와 보이스 용량에 따라 달라지므로
+  // prepare 에서 정합니다.
+  static constexpr int maxVoicesPerPass = maxGrainHeads / grainHeadCounts[0];
+  static constexpr int maxPanChannels = 2;
+  int numMixRows = 0;
+  int mixRow = 0;
+  int sweepRow = 0;     // 샘플별 피치 비율
+  int voiceGainRow = 0; // 지금 렌더링하는 보이스 묶음의 채널 게인
+  int numRampRows = 0;
+  juce::HeapBlock<char> rampMemory;
+  juce::dsp::AudioBlock<float> ramps;
+  juce::HeapBlock<int> readIndex;
+
+  juce::uint32 preparePitchSweep(float length, int numSamples,
+                                 int paddedSamples);
+  void updateWindow();
+  void updateGrainLengthLimit();
+  void updateGrainLengthTarget();
+  juce::uint32 getPhaseIncrement(float length, float ratio) const;
+  juce::uint32 getHeadOffset(int head) const;
+  juce::uint32 getHeadPhase(int head, int sample, juce::uint32 increment) const;
+  juce::uint32 getRephaseTarget(juce::uint32 increment) const;
+  int samplesUntilWrap(int head, int sample, juce::uint32 increment) const;
+  void alignSplice(int head, int startPos, int sample, float length,
+                   juce::uint32 increment);
+  void rephaseHeads(int sample, juce::uint32 increment);
+  void applyTransientGain(juce::AudioBuffer<float> &buffer, int numChannels,
+                          int offset, int numSamples);
+  void writeVoiceSource(const juce::AudioBuffer<float> &input, int numChannels,
+                        int offset, int numSamples);
+  void generateVoiceGains(int voice, int gainRow, int panChannels,
+                          int numSamples, int paddedSamples);
+  void releaseSilentVoices();
+
+  // 채널 수(1, 2, 그 외 N=0), 보간기, 윈도우 정책별로 특수화된 청크 커널.
+  // process()가 블록마다 한 번 디스패치 테이블에서 골라 호출하므로
+  // 내부 루프에는 런타임 분기가 없습니다.
+  using ChunkKernel = void (PitchShifter::*)(juce::AudioBuffer<float> &, int,
+                                             int, int);
+
+  ChunkKernel selectKernel(int numChannels) const;
+
+  template <int NumChannels, typename Window>
+  static constexpr std::array<ChunkKernel, numInterpolationQualities>
+  makeKernelRow();
+
+  template <int NumChannels, typename Interpolator, typename Window>
+  void processChunk(juce::AudioBuffer<float> &buffer, int numChannels,
+                    int offset, int numSamples);
+
+  template <typename Window>
+  void generateRamps(int row, juce::uint32 headPhase, float delayOffset,
+                     int startPos, int from, int to, float length,
+                     float lengthStep, juce::uint32 increment,
+                     const juce::uint32 *phaseOffsets);
+
+  template <typename Window>
+  void generateVoiceRamps(int voice, int firstRow, int startPos,
+                          int numSamples, int paddedSamples, float length,
+                          float lengthStep, int rephaseAt);
+
+  // 램프 행 row 의 헤드 하나를 샘플 i 부터 레인 폭만큼 채널별로 읽어
+  // 윈도우 게인을 곱해 out 에 둡니다. 렌더 루프의 몸통이므로 인라인을
+  // 강제합니다 (호출로 남으면 레지스터가 메모리를 거칩니다).
+  template <int NumChannels, typename Interpolator>
+  forcedinline void readHead(const float *const *sources, int row, int i,
+                SimdLanes::Lanes *out) const;
 
-  // 윈도우 처리
-  static constexpr int windowSize = 4096; // 레이턴시 대 부드러움 조절
-  static constexpr int crossfadeSize = 1024;
+  // 주 보이스의 헤드 행(0..numHeads)을 채널마다 렌더링해 dests 에 씁니다.
+  template <int NumChannels, typename Interpolator>
+  void renderChannels(const float *const *sources, float *const *dests,
+                      int numSamples);
 
-  void updatePitchRatio();
+  // 한 패스에 묶인 numVoices 개 하모니 보이스(보이스마다 numHeads 행)를
+  // 한 채널 source 에서 읽어, 보이스마다 헤드 합에 팬 게인 행
+  // gains[보이스 * NumPans + 채널] 을 곱해 dests 에 더합니다.
+  template <int NumPans, typename Interpolator>
+  void renderVoices(const float *source, float *const *dests,
+                    const float *const *gains, int numVoices, int numSamples);
 };
@@ -0,0 +1,313 @@
+#include "PsolaShifter.h"
+#include "FastMath.h"
+
+PsolaShifter::PsolaShifter() {}
+
+PsolaShifter::~PsolaShifter() {}
+
+void PsolaShifter::prepare(double sr, int samplesPerBlock, int numChannels) {
+  sampleRate = sr;
+  maxBlockSize = juce::jmax(1, samplesPerBlock);
+
+  minPeriod = (int)std::ceil(sampleRate / 1000.0);
+  maxPeriod = (int)std::ceil(sampleRate / 50.0);
+  maxHalfGrain = maxPeriod;
+  period = (float)(sampleRate / 200.0);
+
+  // 레이턴시는 주기와 무관하게 예산(10 ms) 바로 아래로 고정합니다.
+  // 그레인은 항상 두 주기 길이이고, 긴 주기에서 가까운 마크의 그레인
+  // 입력이 아직 다 들어오지 않았으면 placeGrains 가 한 주기씩 앞쪽에서
+  // 자릅니다.
+  latencySamples = (int)(sampleRate * latencyBudgetSeconds) - 1;
+
+  // 그레인 중심은 블록 끝에서 한 블록 + 레이턴시 전까지이고, 자르는 마크는
+  // 그 위치나 (블록 끝 - 반 그레인) 중 이른 쪽보다 최대 5/4 주기 앞입니다.
+  // 그 마크 앞쪽 반 그레인과 마크 탐색을 담을 수 있도록 히스토리를 잡습니다
+  // (버스 채널 수만큼).
+  const int maxReach = juce::jmax(maxBlockSize + latencySamples,
+                                  2 * maxHalfGrain + 2) +
+                       5 * maxPeriod / 4 + maxHalfGrain;
+  history.setSize(juce::jlimit(1, 2, numChannels), maxReach + 2, historyGuard);
+
+  // 그 구간에 가장 짧은 간격(최소 주기의 3/4)으로 찍힐 수 있는 마크 수
+  const int maxMarks =
+      juce::nextPowerOfTwo(maxReach * 4 / (3 * minPeriod) + 4);
+  marks.allocate((size_t)maxMarks, true);
+  markMask = maxMarks - 1;
+
+  // 출력 시각 t 는 그레인 중심 c 에서 반 그레인 안이고, 그레인은 마크 m
+  // 주변을 포먼트 비율로 읽으므로 t 가 읽는 입력은 t - (c - m) 에서 반 그레인
+  // + 보간 한 샘플 앞까지입니다. c - m 은 그레인이 두 마크 사이면 레이턴시
+  // + 마크 간격(최대 5/4 주기)의 절반, 다음 마크를 모르면 반 그레인 + 5/4
+  // 주기, 한 주기씩 물러났으면 반 그레인 두 개 + 한 주기까지입니다.
+  tailSamples = juce::jmax(latencySamples + 5 * maxPeriod / 8 + 1,
+                           maxHalfGrain + 5 * maxPeriod / 4 + 2,
+                           2 * maxHalfGrain + maxPeriod + 2) +
+                maxHalfGrain + 1;
+
+  // 출력 누산은 현재 블록 뒤로 그레인 하나(양쪽 반 그레인)까지 씁니다.
+  const int outputSize =
+      juce::nextPowerOfTwo(maxBlockSize + 4 * maxHalfGrain + 2);
+  weightChannel = history.getNumChannels();
+  output.setSize(weightChannel + 1, outputSize);
+  outputMask = outputSize - 1;
+
+  reset();
+}
+
+void PsolaShifter::reset() {
+  history.clear();
+  output.clear();
+  inputTime = 0;
+  numMarks = 0;
+  newestMark = 0;
+  nextMark = 0;
+  // 첫 그레인이 가장 오래된 마크에 맞춰지도록 모든 마크보다 앞에 둡니다.
+  nextGrain = std::numeric_limits<double>::lowest();
+  spacingPending = false;
+  pitch.finish();
+}
+
+void PsolaShifter::setPitch(float semitones, int rampSamples) {
+  pitch.setTarget(semitones, rampSamples);
+}
+
+void PsolaShifter::setFormantShift(float semitones) {
+  semitones = juce::jlimit(-maxFormantShift, maxFormantShift, semitones);
+
+  if (!juce::exactlyEqual(currentFormantShift, semitones)) {
+    currentFormantShift = semitones;
+    formantRatio = FastMath::semitonesToRatio(currentFormantShift);
+  }
+}
+
+void PsolaShifter::setDetectedPeriod(float periodSamples, float confidence) {
+  if (confidence >= minPeriodConfidence && periodSamples > 0.0f)
+    period = juce::jlimit((float)minPeriod, (float)maxPeriod, periodSamples);
+}
+
+void PsolaShifter::process(juce::AudioBuffer<float> &buffer) {
+  const int numChannels =
+      juce::jmin(buffer.getNumChannels(), history.getNumChannels());
+  const int totalSamples = buffer.getNumSamples();
+
+  for (int offset = 0; offset < totalSamples; offset += maxBlockSize) {
+    const int numSamples = juce::jmin(maxBlockSize, totalSamples - offset);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+      history.writeBlock(ch, buffer.getReadPointer(ch, offset), numSamples);
+
+    history.advance(numSamples);
+    inputTime += numSamples;
+
+    const juce::int64 blockStart = inputTime - numSamples;
+    updateMarks(numChannels);
+    placeGrains(blockStart, inputTime, numChannels);
+    pitch.skip(numSamples);
+
+    // 누산 결과를 겹침 가중치로 정규화해 내보내고 자리를 비웁니다.
+    float *weight = output.getWritePointer(weightChannel);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      float *dest = buffer.getWritePointer(ch, offset);
+      float *accum = output.getWritePointer(ch);
+
+      for (int i = 0; i < numSamples; ++i) {
+        const int index = (int)((blockStart + i) & outputMask);
+        dest[i] = accum[index] / juce::jmax(weight[index], minOverlapWeight);
+        accum[index] = 0.0f;
+      }
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+      weight[(blockStart + i) & outputMask] = 0.0f;
+  }
+}
+
+void PsolaShifter::updateMarks(int numChannels) {
+  // 이전 마크에서 한 주기 뒤를 중심으로 ±1/4 주기 안의 최댓값에
+  // 다음 마크를 맞춥니다. 탐색 범위가 다 기록된 마크까지만 찍습니다.
+  const int mask = history.getMask();
+  const float *left = history.getReadPointer(0);
+  const float *right = history.getReadPointer(numChannels > 1 ? 1 : 0);
+  const int step = juce::roundToInt(period);
+  const int radius = step / 4;
+
+  // 시작 직후이거나 탐색 범위가 히스토리 밖으로 밀려났으면 다시 잡습니다.
+  // 그 밖에는 블록이 길어도 이어서 찍어, 레이턴시 뒤의 그레인이 쓸 마크가
+  // 빠지지 않게 합니다.
+  if (numMarks == 0 ||
+      nextMark - radius < inputTime - (juce::int64)history.getCapacity())
+    nextMark = inputTime - step;
+
+  while (nextMark + radius < inputTime) {
+    juce::int64 best = nextMark;
+    float bestValue = -std::numeric_limits<float>::max();
+
+    for (juce::int64 t = nextMark - radius; t <= nextMark + radius; ++t) {
+      const int index = (int)(t & mask);
+      const float value = left[index] + right[index];
+
+      if (value > bestValue) {
+        bestValue = value;
+        best = t;
+      }
+    }
+
+    newestMark = (newestMark + 1) & markMask;
+    marks[newestMark] = best;
+    numMarks = juce::jmin(numMarks + 1, markMask + 1);
+    nextMark = best + step;
+  }
+}
+
+juce::int64 PsolaShifter::getMark(int age) const {
+  // age 0 이 가장 최근 마크
+  return marks[(newestMark - age) & markMask];
+}
+
+void PsolaShifter::placeGrains(juce::int64 blockStart, juce::int64 blockEnd,
+                               int numChannels) {
+  if (numMarks == 0)
+    return;
+
+  // 반 그레인은 한 주기까지이되, 입력 쪽과 출력 쪽(= 입력 쪽 / 포먼트 비율)
+  // 모두 상한을 넘지 않게 합니다.
+  const float inputHalf =
+      juce::jmin(period, (float)maxHalfGrain, (float)maxHalfGrain * formantRatio);
+  const float outputHalf = inputHalf / formantRatio;
+
+  // 출력이 시작되기 직전까지 그레인 배치를 미뤄, 다음 마크까지 검출된
+  // 뒤에 그레인을 자릅니다.
+  while (nextGrain - (double)outputHalf < (double)blockEnd) {
+    // 다음 마크를 모른 채 검출 주기로 그레인을 띄웠으면, 그 마크가 검출된
+    // 지금 다음 그레인 위치를 실제 마크 간격에 맞춰 다시 잡습니다. 기준
+    // 마크에서 몇 주기 지났는지를 유지하므로, 긴 주기에서도 그레인이 마크
+    // 열을 따라가 피치 0 이 원음에 맞습니다.
+    while (spacingPending && getMark(0) > pendingMark) {
+      int age = 0;
+      while (age + 1 < numMarks && getMark(age + 1) > pendingMark)
+        ++age;
+
+      const juce::int64 next = getMark(age);
+      const double periods =
+          (nextGrain - (double)(latencySamples + pendingMark)) / pendingSpacing;
+
+      if (periods < 1.0) {
+        nextGrain = (double)(latencySamples + pendingMark) +
+                    periods * (double)(next - pendingMark);
+        spacingPending = false;
+      } else {
+        nextGrain = (double)(latencySamples + next) +
+                    (periods - 1.0) * pendingSpacing;
+        pendingMark = next;
+      }
+    }
+
+    const double position = nextGrain - (double)latencySamples;
+
+    // position 이전의 가장 최근 마크
+    int age = 0;
+    while (age < numMarks && (double)getMark(age) > position)
+      ++age;
+
+    // 리셋 직후처럼 position 이 모든 마크보다 앞이면 가장 오래된 마크의
+    // 그레인 위치로 건너뜁니다 (그 사이는 무음).
+    if (age == numMarks) {
+      nextGrain = (double)(getMark(numMarks - 1) + latencySamples);
+      spacingPending = false;
+      continue;
+    }
+
+    // 두 마크 사이에서는 그 간격을, 다음 마크가 아직 없으면 검출 주기를
+    // 입력 쪽 간격으로 씁니다.
+    const juce::int64 previous = getMark(age);
+    juce::int64 nearest = previous;
+    double spacing = (double)period;
+
+    if (age > 0) {
+      const juce::int64 next = getMark(age - 1);
+      spacing = (double)(next - previous);
+
+      if ((double)next - position < position - (double)previous)
+        nearest = next;
+    }
+
+    // 그레인은 더 가까운 마크에서 자르되, 그레인 입력이 아직 다 기록되지
+    // 않았으면 검출 주기만큼씩 물러납니다. 주기 신호에서는 한 주기 앞
+    // 그레인도 같은 모양이므로 피치 0 에서 출력이 입력을 그대로 따릅니다.
+    // 정수 마크 간격 대신 주기를 빼므로 물러난 그레인도 소수 샘플 위상이
+    // 맞고, 리셋 직후에는 아직 기록 전인 구간(무음)을 읽습니다.
+    double mark = (double)nearest;
+
+    while (mark + (double)inputHalf + 1.0 >= (double)inputTime)
+      mark -= (double)period;
+
+    // 다음 그레인까지의 출력 간격은 이 그레인 시각의 음정으로 정합니다.
+    // 블록 뒤쪽 그레인은 램프가 이어질 값을 미리 읽습니다.
+    const int rampOffset = (int)juce::jmax(0.0, nextGrain - (double)blockStart);
+    const float pitchRatio =
+        FastMath::semitonesToRatio(pitch.getValueAt(rampOffset));
+
+    addGrain(mark, nextGrain, outputHalf, blockStart, numChannels);
+    nextGrain += spacing / (double)pitchRatio;
+
+    if (age == 0 && !spacingPending) {
+      spacingPending = true;
+      pendingMark = previous;
+      pendingSpacing = spacing;
+    }
+  }
+}
+
+void PsolaShifter::addGrain(double mark, double centre, float outputHalf,
+                            juce::int64 blockStart, int numChannels) {
+  const int mask = history.getMask();
+  const auto markFloor = (juce::int64)std::floor(mark);
+  const auto markFraction = (float)(mark - (double)markFloor);
+  // 이미 내보낸 출력 앞쪽은 버립니다 (리셋 직후에만 생김).
+  const auto first = juce::jmax(
+      blockStart, (juce::int64)std::ceil(centre - (double)outputHalf));
+  const auto last = (juce::int64)std::floor(centre + (double)outputHalf);
+  const float offset = (float)((double)first - centre);
+
+  // Hann 윈도우 cos 값은 2차 점화식으로 샘플마다 갱신합니다.
+  const float theta = juce::MathConstants<float>::pi / outputHalf;
+  const float twoCos = 2.0f * std::cos(theta);
+  float cosCurrent = std::cos(theta * offset);
+  float cosPrevious = std::cos(theta * (offset - 1.0f));
+
+  float *weight = output.getWritePointer(weightChannel);
+  // 모노 버스면 히스토리와 누산 모두 채널이 하나뿐입니다.
+  float *accum[2] = {output.getWritePointer(0), nullptr};
+  const float *source[2] = {history.getReadPointer(0), nullptr};
+
+  if (numChannels > 1) {
+    accum[1] = output.getWritePointer(1);
+    source[1] = history.getReadPointer(1);
+  }
+
+  for (juce::int64 t = first; t <= last; ++t) {
+    const auto k = (float)((double)t - centre);
+    const float window = 0.5f + 0.5f * cosCurrent;
+
+    const float position = k * formantRatio + markFraction;
+    const float floorPosition = std::floor(position);
+    const juce::int64 i0 = markFloor + (juce::int64)floorPosition;
+    const float frac = position - floorPosition;
+    const int a = (int)(i0 & mask);
+    const int b = (int)((i0 + 1) & mask);
+    const int index = (int)(t & outputMask);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      const float *x = source[ch];
+      accum[ch][index] += window * (x[a] + frac * (x[b] - x[a]));
+    }
+
+    weight[index] += window;
+
+    const float cosNext = twoCos * cosCurrent - cosPrevious;
+    cosPrevious = cosCurrent;
+    cosCurrent = cosNext;
+  }
+}
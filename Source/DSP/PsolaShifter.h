@@ -0,0 +1,109 @@
+#pragma once
+
+#include "PitchEngine.h"
+#include "PitchRamp.h"
+#include "RingBuffer.h"
+#include <JuceHeader.h>
+
+// 피치 동기 오버랩-애드(TD-PSOLA) 엔진.
+// 검출된 주기 간격으로 입력에 분석 마크(에포크)를 찍고, 각 마크를 중심으로
+// 자른 Hann 그레인을 출력 쪽에서 주기 / 피치 비율 간격으로 다시 배치합니다.
+// 그레인 내용은 늘이거나 줄이지 않으므로 포먼트가 그대로 남고,
+// 그레인을 포먼트 비율로 리샘플링하면 피치와 따로 포먼트를 옮길 수 있습니다.
+// 입력 히스토리는 그레인 엔진과 같은 RingBuffer 클래스를 쓰지만 엔진마다
+// 따로 두며, 두 엔진이 기록을 공유하지는 않습니다.
+//
+// 비용: 그레인 엔진과 비슷한 수준이 목표였지만 닿지 못합니다. 그레인이
+// 두 주기 길이라 출력 샘플마다 두세 개가 겹치고, 겹침 가중치로 나누는
+// 정규화가 더해집니다. YAMMYBenchmark 의 psola / grain 비율은 블록 64
+// 이상에서 약 4.5배입니다 (220 Hz 입력, +5 반음).
+class PsolaShifter : public PitchEngine {
+public:
+  PsolaShifter();
+  ~PsolaShifter() override;
+
+  void prepare(double sampleRate, int samplesPerBlock,
+               int numChannels) override;
+  void reset() override;
+  using PitchEngine::setPitch;
+  void setPitch(float semitones, int rampSamples) override;
+  void setFormantShift(float semitones);
+  void setDetectedPeriod(float periodSamples, float confidence);
+  void process(juce::AudioBuffer<float> &buffer) override;
+
+  // 출력 시각 t 의 그레인은 입력 시각 t - latencySamples 근처의 마크에서
+  // 자르므로, 피치 0 이면 각 마크의 그레인이 정확히 레이턴시 뒤에 놓입니다.
+  // 주기가 길어 그 마크의 그레인 입력이 아직 없으면 검출 주기만큼 앞에서
+  // 자릅니다. 레이턴시는 블록 크기나 주기와 무관하게 고정됩니다.
+  int getLatencySamples() const override { return latencySamples; }
+  int getMaxLatencySamples() const override { return latencySamples; }
+
+  // 입력이 끝난 뒤 그레인이 그 입력을 읽어 내보낼 수 있는 가장 긴 시간.
+  // 긴 주기에서는 한 주기 앞에서 자른 그레인이 레이턴시보다 훨씬 뒤까지
+  // 남으므로 기본값(레이턴시 두 배)보다 깁니다.
+  int getTailSamples() const override { return tailSamples; }
+
+  static constexpr float maxFormantShift = 12.0f;
+
+private:
+  void updateMarks(int numChannels);
+  void placeGrains(juce::int64 blockStart, juce::int64 blockEnd,
+                   int numChannels);
+  void addGrain(double mark, double centre, float outputHalf,
+                juce::int64 blockStart, int numChannels);
+  juce::int64 getMark(int age) const;
+
+  double sampleRate = 44100.0;
+  int maxBlockSize = 0;
+
+  // 입력 히스토리와 절대 샘플 시각 (히스토리 쓰기 위치와 같이 움직입니다)
+  RingBuffer history;
+  static constexpr int historyGuard = 2;
+  juce::int64 inputTime = 0;
+
+  // 출력 오버랩-애드 누산 (히스토리 채널마다 하나) 과 그 뒤 채널의 윈도우
+  // 가중치 합
+  juce::AudioBuffer<float> output;
+  int outputMask = 0;
+  int weightChannel = 0;
+  // 겹침이 얇은 곳(아래로 시프트)을 과하게 키우지 않도록 하는 정규화 하한
+  static constexpr float minOverlapWeight = 0.5f;
+
+  // 분석 마크: 레이턴시와 한 블록 동안 찍힐 수 있는 만큼을 원형으로
+  // 보관합니다 (크기는 prepare 에서 2의 거듭제곱으로 정함).
+  juce::HeapBlock<juce::int64> marks;
+  int markMask = 0;
+  int numMarks = 0;
+  int newestMark = 0;
+  juce::int64 nextMark = 0;
+
+  // 다음 합성 그레인 중심 (출력 시각). 그레인은 입력 쪽 nextGrain -
+  // latencySamples 위치를 둘러싼 두 마크 간격 / 피치 비율마다 놓입니다.
+  double nextGrain = 0.0;
+  int latencySamples = 0;
+  int tailSamples = 0;
+
+  // 다음 마크를 모른 채 검출 주기(pendingSpacing)로 그레인을 띄운 기준 마크
+  bool spacingPending = false;
+  juce::int64 pendingMark = 0;
+  double pendingSpacing = 0.0;
+
+  // 주기 (샘플). 신뢰도가 낮으면 마지막 값을 유지합니다.
+  float period = 0.0f;
+  int minPeriod = 0;
+  int maxPeriod = 0;
+  static constexpr float minPeriodConfidence = 0.8f;
+
+  // 반 그레인은 검출 주기 그대로이고, 상한은 가장 긴 주기입니다.
+  int maxHalfGrain = 0;
+
+  // 저지연 경로라 레이턴시를 10 ms 아래(48 kHz 에서 479 샘플)로 둡니다.
+  static constexpr double latencyBudgetSeconds = 0.01;
+
+  // 음정 램프는 그레인마다 그 그레인 중심(출력 시각)의 값으로 읽습니다.
+  PitchRamp pitch;
+  float currentFormantShift = 0.0f;
+  float formantRatio = 1.0f;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PsolaShifter)
+};
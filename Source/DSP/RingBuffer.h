@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// 2의 거듭제곱 용량을 가진 다채널 원형 히스토리 버퍼.
+// 인덱스는 비트 마스크로 래핑되고, 버퍼 앞부분 guard 샘플을 용량 뒤에
+// 그대로 복제(미러링)해 둡니다. 덕분에 보간기는 i0..i0+guard 범위를
+// 래핑 검사 없이 연속된 메모리로 읽을 수 있습니다.
+class RingBuffer {
+public:
+  void setSize(int numChannels, int minimumCapacity, int guardSamples) {
+    capacity = juce::nextPowerOfTwo(juce::jmax(minimumCapacity, 2));
+    mask = capacity - 1;
+    guard = juce::jlimit(1, capacity, guardSamples);
+
+    data.setSize(numChannels, capacity + guard);
+    clear();
+  }
+
+  void clear() {
+    data.clear();
+    writePos = 0;
+  }
+
+  int getNumChannels() const { return data.getNumChannels(); }
+  int getCapacity() const { return capacity; }
+  int getMask() const { return mask; }
+  int getGuard() const { return guard; }
+  int getWritePosition() const { return writePos; }
+
+  // 현재 쓰기 위치부터 블록을 통째로 기록합니다 (위치는 advance()로 전진).
+  // 래핑되는 경우 두 번의 memcpy로 나누고, 가드 영역에 해당하는 앞부분은
+  // 꼬리에도 복제합니다.
+  void writeBlock(int channel, const float *source, int numSamples) {
+    jassert(numSamples <= capacity);
+
+    auto *d = data.getWritePointer(channel);
+    const int first = juce::jmin(numSamples, capacity - writePos);
+
+    std::memcpy(d + writePos, source, (size_t)first * sizeof(float));
+    std::memcpy(d, source + first, (size_t)(numSamples - first) * sizeof(float));
+
+    if (writePos < guard || writePos + numSamples > capacity)
+      std::memcpy(d + capacity, d, (size_t)guard * sizeof(float));
+  }
+
+  void advance(int numSamples = 1) {
+    writePos = (writePos + numSamples) & mask;
+  }
+
+  // 쓰기 위치에서 delaySamples 만큼 과거의 인덱스 (마스크 적용됨)
+  int indexForDelay(int delaySamples) const {
+    return (writePos - delaySamples) & mask;
+  }
+
+  // source 를 기록하고 delaySamples 만큼 지연된 같은 길이의 구간을 dest 에
+  // 씁니다 (source 와 dest 는 같아도 됩니다). 블록을 먼저 써 두므로 지연이
+  // 블록보다 짧아도 읽을 구간이 모두 링 안에 있습니다 (용량 >= 지연 + 블록).
+  // 래핑될 때만 두 번에 나눠 복사하며, 위치는 모든 채널 뒤에 advance()로
+  // 전진합니다.
+  void delayBlock(int channel, const float *source, float *dest, int numSamples,
+                  int delaySamples) {
+    jassert(delaySamples + numSamples <= capacity);
+
+    writeBlock(channel, source, numSamples);
+
+    const float *d = data.getReadPointer(channel);
+    const int start = indexForDelay(delaySamples);
+    const int first = juce::jmin(numSamples, capacity - start);
+
+    std::memcpy(dest, d + start, (size_t)first * sizeof(float));
+    std::memcpy(dest + first, d, (size_t)(numSamples - first) * sizeof(float));
+  }
+
+  const float *getReadPointer(int channel) const {
+    return data.getReadPointer(channel);
+  }
+
+private:
+  juce::AudioBuffer<float> data;
+  int capacity = 0;
+  int mask = 0;
+  int guard = 1;
+  int writePos = 0;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// 블록 단위 무음 검출기.
+// 채널마다 FloatVectorOperations::findMinAndMax 로 최솟값/최댓값만 구해
+// 임계값과 비교하므로 샘플당 비용은 벡터 비교 한 번 수준입니다.
+// 입력이 연속으로 무음이었던 샘플 수를 세어, 프로세서가 엔진의 꼬리가
+// 다 빠졌는지 판단할 수 있게 합니다.
+class SilenceDetector {
+public:
+  void reset() { silentSamples = 0; }
+
+  void process(const juce::AudioBuffer<float> &buffer, int numChannels) {
+    const int numSamples = buffer.getNumSamples();
+
+    if (!buffer.hasBeenCleared()) {
+      for (int channel = 0; channel < numChannels; ++channel) {
+        const auto range = juce::FloatVectorOperations::findMinAndMax(
+            buffer.getReadPointer(channel), numSamples);
+
+        if (range.getStart() < -threshold || range.getEnd() > threshold) {
+          silentSamples = 0;
+          return;
+        }
+      }
+    }
+
+    silentSamples = juce::jmin(silentSamples + numSamples, maxCount);
+  }
+
+  // 현재 블록 끝까지 이어진 무음 길이 (샘플)
+  int getSilentSamples() const { return silentSamples; }
+
+  // 약 -120 dBFS
+  static constexpr float threshold = 1.0e-6f;
+
+private:
+  static constexpr int maxCount = std::numeric_limits<int>::max() / 2;
+  int silentSamples = 0;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// 샘플 축으로 벡터화된 커널들이 공유하는 SIMD 레인 타입과 헬퍼.
+// 한 레지스터에 연속된 샘플 width개를 담습니다.
+// SIMD를 쓸 수 없는 빌드에서는 폭 1의 스칼라로 대체되어
+// 같은 커널 코드가 그대로 컴파일됩니다.
+namespace SimdLanes {
+#if JUCE_USE_SIMD
+using Lanes = juce::dsp::SIMDRegister<float>;
+constexpr int width = (int)Lanes::size();
+
+inline Lanes load(const float *p) { return Lanes::fromRawArray(p); }
+inline void store(Lanes v, float *p) { v.copyToRawArray(p); }
+inline Lanes expand(float s) { return Lanes::expand(s); }
+#else
+using Lanes = float;
+constexpr int width = 1;
+
+inline Lanes load(const float *p) { return *p; }
+inline void store(Lanes v, float *p) { *p = v; }
+inline Lanes expand(float s) { return s; }
+#endif
+
+// load/store에 넘기는 배열은 이 정렬을 지켜야 합니다.
+constexpr int alignment = width * (int)sizeof(float);
+
+// 루프가 꼬리 처리 없이 돌 수 있도록 레인 폭의 배수로 올림
+inline int padToWidth(int numSamples) {
+  return (numSamples + width - 1) & ~(width - 1);
+}
+
+// 정렬되지 않은 두 배열의 내적. 레인 폭만큼 부분합을 나눠 두어
+// 컴파일러가 재결합 없이도 벡터화할 수 있게 합니다.
+inline float dot(const float *a, const float *b, int numSamples) {
+  float partial[width] = {};
+  int i = 0;
+
+  for (; i + width <= numSamples; i += width)
+    for (int k = 0; k < width; ++k)
+      partial[k] += a[i + k] * b[i + k];
+
+  float sum = 0.0f;
+  for (int k = 0; k < width; ++k)
+    sum += partial[k];
+
+  for (; i < numSamples; ++i)
+    sum += a[i] * b[i];
+
+  return sum;
+}
+} // namespace SimdLanes
@@ -0,0 +1,277 @@
+#include "SpectralShifter.h"
+#include "FastMath.h"
+
+namespace {
+constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+// [-pi, pi) 로 위상 래핑 (분기 없이 벡터화됩니다)
+inline float wrapPhase(float x) {
+  return x - twoPi * std::floor(x * (1.0f / twoPi) + 0.5f);
+}
+} // namespace
+
+SpectralShifter::SpectralShifter() {}
+
+SpectralShifter::~SpectralShifter() {}
+
+void SpectralShifter::prepare(double sr, int samplesPerBlock,
+                              int numChannels) {
+  juce::ignoreUnused(samplesPerBlock);
+  sampleRate = sr;
+
+  fftSize = juce::nextPowerOfTwo((int)std::ceil(sampleRate * frameSeconds));
+  hopSize = fftSize / overlap;
+  numBins = fftSize / 2 + 1;
+  lifterLength = juce::jlimit(1, fftSize / 2 - 1,
+                              (int)std::round(sampleRate * lifterSeconds));
+
+  const int fftOrder = juce::roundToInt(std::log2((double)fftSize));
+  fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+  // 주기 Hann 분석/합성 윈도우. 4배 오버랩에서 Hann^2 의 합은 1.5 이므로
+  // 합성 윈도우에 그 역수를 미리 곱해 둡니다.
+  analysisWindow.allocate((size_t)fftSize, false);
+  synthesisWindow.allocate((size_t)fftSize, false);
+
+  float overlapSum = 0.0f;
+  for (int i = 0; i < fftSize; ++i) {
+    analysisWindow[i] =
+        0.5f - 0.5f * std::cos(twoPi * (float)i / (float)fftSize);
+    overlapSum += analysisWindow[i] * analysisWindow[i];
+  }
+
+  const float synthesisGain = (float)hopSize / overlapSum;
+  juce::FloatVectorOperations::copyWithMultiply(
+      synthesisWindow.get(), analysisWindow.get(), synthesisGain, fftSize);
+
+  // 채널별 프레임/위상 상태는 버스 채널 수만큼만 둡니다.
+  numChannels = juce::jmax(1, numChannels);
+  inputFrames.setSize(numChannels, fftSize);
+  outputAccum.setSize(numChannels, fftSize);
+  outputReady.setSize(numChannels, hopSize);
+  lastPhase.setSize(numChannels, numBins);
+  synthPhase.setSize(numChannels, numBins);
+
+  fftData.allocate((size_t)(2 * fftSize), true);
+  magnitude.allocate((size_t)numBins, true);
+  phase.allocate((size_t)numBins, true);
+  phaseAdvance.allocate((size_t)numBins, true);
+  shiftedMagnitude.allocate((size_t)numBins, true);
+  shiftedPhase.allocate((size_t)numBins, true);
+  envelope.allocate((size_t)numBins, true);
+  peaks.allocate((size_t)numBins, true);
+
+  reset();
+}
+
+void SpectralShifter::reset() {
+  inputFrames.clear();
+  outputAccum.clear();
+  outputReady.clear();
+  lastPhase.clear();
+  synthPhase.clear();
+  frameFill = fftSize - hopSize;
+  pitch.finish();
+}
+
+void SpectralShifter::setPitch(float semitones, int rampSamples) {
+  pitch.setTarget(semitones, rampSamples);
+}
+
+void SpectralShifter::setFormantPreservation(bool shouldPreserve) {
+  formantPreservation = shouldPreserve;
+}
+
+void SpectralShifter::process(juce::AudioBuffer<float> &buffer) {
+  const int numChannels =
+      juce::jmin(buffer.getNumChannels(), inputFrames.getNumChannels());
+  const int numSamples = buffer.getNumSamples();
+  const int carried = fftSize - hopSize;
+
+  // 프레임 경계까지 블록 단위로 입력을 모으고, 이전 프레임이 완성한
+  // 홉 출력을 같은 위치에서 내보냅니다. 프레임이 처리되면 최근
+  // carried 샘플은 다음 프레임의 앞부분으로 남습니다.
+  for (int offset = 0; offset < numSamples;) {
+    const int n = juce::jmin(numSamples - offset, fftSize - frameFill);
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+      float *io = buffer.getWritePointer(ch, offset);
+
+      juce::FloatVectorOperations::copy(
+          inputFrames.getWritePointer(ch, frameFill), io, n);
+      juce::FloatVectorOperations::copy(
+          io, outputReady.getReadPointer(ch, frameFill - carried), n);
+    }
+
+    frameFill += n;
+    offset += n;
+
+    if (frameFill == fftSize) {
+      pitchRatio = FastMath::semitonesToRatio(pitch.getValueAt(offset));
+
+      for (int ch = 0; ch < numChannels; ++ch)
+        processFrame(ch);
+
+      frameFill = carried;
+    }
+  }
+
+  pitch.skip(numSamples);
+}
+
+void SpectralShifter::processFrame(int channel) {
+  analyse(channel);
+
+  if (formantPreservation) {
+    estimateEnvelope();
+
+    float *mag = magnitude.get();
+    const float *env = envelope.get();
+    for (int k = 0; k < numBins; ++k)
+      mag[k] /= env[k];
+  }
+
+  shiftPeaks(channel);
+
+  if (formantPreservation)
+    juce::FloatVectorOperations::multiply(shiftedMagnitude.get(),
+                                          envelope.get(), numBins);
+
+  synthesise(channel);
+}
+
+void SpectralShifter::analyse(int channel) {
+  float *frame = inputFrames.getWritePointer(channel);
+  float *data = fftData.get();
+
+  juce::FloatVectorOperations::multiply(data, frame, analysisWindow.get(),
+                                        fftSize);
+  juce::FloatVectorOperations::clear(data + fftSize, fftSize);
+
+  // 다음 프레임을 위해 입력을 한 홉 밀어 둡니다.
+  std::memmove(frame, frame + hopSize,
+               (size_t)(fftSize - hopSize) * sizeof(float));
+
+  fft->performRealOnlyForwardTransform(data, true);
+
+  float *mag = magnitude.get();
+  float *ph = phase.get();
+
+  for (int k = 0; k < numBins; ++k) {
+    const float re = data[2 * k];
+    const float im = data[2 * k + 1];
+    mag[k] = std::sqrt(re * re + im * im);
+  }
+
+  for (int k = 0; k < numBins; ++k)
+    ph[k] = std::atan2(data[2 * k + 1], data[2 * k]);
+
+  // 빈 중심 주파수의 기대 위상 진행과의 차이로 실제 진행량을 구합니다.
+  float *last = lastPhase.getWritePointer(channel);
+  float *advance = phaseAdvance.get();
+  const float expectedStep = twoPi * (float)hopSize / (float)fftSize;
+
+  for (int k = 0; k < numBins; ++k) {
+    const float expected = (float)k * expectedStep;
+    advance[k] = expected + wrapPhase(ph[k] - last[k] - expected);
+    last[k] = ph[k];
+  }
+}
+
+void SpectralShifter::estimateEnvelope() {
+  // 분석이 끝난 뒤 비어 있는 FFT 작업 영역을 그대로 씁니다.
+  // log|X| -> 역변환(실수 켑스트럼) -> 리프터 -> 정변환의 실수부 = log 포락선
+  float *data = fftData.get();
+  const float *mag = magnitude.get();
+
+  for (int k = 0; k < numBins; ++k) {
+    data[2 * k] = std::log(mag[k] + 1.0e-9f);
+    data[2 * k + 1] = 0.0f;
+  }
+
+  juce::FloatVectorOperations::clear(data + 2 * numBins,
+                                     2 * fftSize - 2 * numBins);
+  fft->performRealOnlyInverseTransform(data);
+
+  // 켑스트럼은 대칭이므로 양 끝 lifterLength 만 남깁니다.
+  juce::FloatVectorOperations::clear(data + lifterLength + 1,
+                                     fftSize - 2 * lifterLength - 1);
+  juce::FloatVectorOperations::clear(data + fftSize, fftSize);
+  fft->performRealOnlyForwardTransform(data, true);
+
+  float *env = envelope.get();
+  for (int k = 0; k < numBins; ++k)
+    env[k] = std::exp(data[2 * k]);
+}
+
+void SpectralShifter::shiftPeaks(int channel) {
+  const float *mag = magnitude.get();
+  const float *ph = phase.get();
+  const float *advance = phaseAdvance.get();
+  float *outMag = shiftedMagnitude.get();
+  float *outPhase = shiftedPhase.get();
+  float *synth = synthPhase.getWritePointer(channel);
+
+  juce::FloatVectorOperations::clear(outMag, numBins);
+
+  int numPeaks = 0;
+  for (int k = 1; k < numBins - 1; ++k)
+    if (mag[k] > mag[k - 1] && mag[k] >= mag[k + 1])
+      peaks[numPeaks++] = k;
+
+  // 각 피크는 이웃 피크와의 중간점까지를 영향 영역으로 가집니다.
+  // 피크의 합성 위상은 옮겨 간 빈의 누산 위상에서 비율만큼 빨라진
+  // 진행량으로 이어 가고, 영역 안의 빈은 피크와의 분석 위상 차를
+  // 그대로 더해 함께 회전시킵니다. 아래로 옮길 때 영역이 겹치면
+  // 위상이 다른 성분을 더하는 대신 더 큰 성분을 남깁니다.
+  for (int i = 0; i < numPeaks; ++i) {
+    const int p = peaks[i];
+    const int target = (int)std::lround((float)p * pitchRatio);
+
+    if (target >= numBins)
+      break;
+
+    const int lo = i == 0 ? 0 : (peaks[i - 1] + p) / 2 + 1;
+    const int hi = i == numPeaks - 1 ? numBins : (p + peaks[i + 1]) / 2 + 1;
+    const int shift = target - p;
+    const float peakPhase = wrapPhase(synth[target] + pitchRatio * advance[p]);
+
+    const int from = juce::jmax(lo, -shift);
+    const int to = juce::jmin(hi, numBins - shift);
+
+    for (int k = from; k < to; ++k) {
+      if (mag[k] > outMag[k + shift]) {
+        const float rotated = wrapPhase(peakPhase + ph[k] - ph[p]);
+        outMag[k + shift] = mag[k];
+        outPhase[k + shift] = rotated;
+        synth[k + shift] = rotated;
+      }
+    }
+  }
+}
+
+void SpectralShifter::synthesise(int channel) {
+  float *data = fftData.get();
+  const float *outMag = shiftedMagnitude.get();
+  const float *outPhase = shiftedPhase.get();
+
+  for (int k = 0; k < numBins; ++k) {
+    data[2 * k] = outMag[k] * std::cos(outPhase[k]);
+    data[2 * k + 1] = outMag[k] * std::sin(outPhase[k]);
+  }
+
+  juce::FloatVectorOperations::clear(data + 2 * numBins,
+                                     2 * fftSize - 2 * numBins);
+  fft->performRealOnlyInverseTransform(data);
+
+  // 합성 윈도우를 곱해 누산하고, 완성된 첫 홉을 출력으로 넘깁니다.
+  float *accum = outputAccum.getWritePointer(channel);
+  juce::FloatVectorOperations::addWithMultiply(accum, data,
+                                               synthesisWindow.get(), fftSize);
+  juce::FloatVectorOperations::copy(outputReady.getWritePointer(channel),
+                                    accum, hopSize);
+
+  std::memmove(accum, accum + hopSize,
+               (size_t)(fftSize - hopSize) * sizeof(float));
+  juce::FloatVectorOperations::clear(accum + fftSize - hopSize, hopSize);
+}
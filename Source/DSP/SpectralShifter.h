@@ -0,0 +1,85 @@
+#pragma once
+
+#include "PitchEngine.h"
+#include "PitchRamp.h"
+#include <JuceHeader.h>
+
+// STFT 위상 보코더 피치 시프터 (폴리포닉 "클린" 경로).
+// 분석 스펙트럼의 피크를 피치 비율만큼 다른 빈으로 옮기고, 피크 주변
+// 빈은 피크와의 위상 차이를 그대로 유지해(identity phase locking)
+// 화음에서도 위상이 흩어지지 않게 합니다.
+// 모든 프레임, 위상 누산기, 윈도우는 prepare에서 할당됩니다.
+class SpectralShifter : public PitchEngine {
+public:
+  SpectralShifter();
+  ~SpectralShifter() override;
+
+  void prepare(double sampleRate, int samplesPerBlock,
+               int numChannels) override;
+  void reset() override;
+  using PitchEngine::setPitch;
+  void setPitch(float semitones, int rampSamples) override;
+  void setFormantPreservation(bool shouldPreserve);
+  void process(juce::AudioBuffer<float> &buffer) override;
+
+  // 프레임이 완성된 뒤에야 그 프레임의 첫 홉(프레임 맨 앞 입력)을
+  // 내보내므로 레이턴시는 프레임 길이 하나로 고정됩니다.
+  int getLatencySamples() const override { return fftSize; }
+  int getMaxLatencySamples() const override { return fftSize; }
+
+  // 마지막 입력이 들어간 프레임이 모두 오버랩-애드될 때까지
+  int getTailSamples() const override { return 2 * fftSize; }
+
+private:
+  void processFrame(int channel);
+  void analyse(int channel);
+  void estimateEnvelope();
+  void shiftPeaks(int channel);
+  void synthesise(int channel);
+
+  double sampleRate = 44100.0;
+
+  // 프레임 길이는 약 85 ms 를 담는 2의 거듭제곱, 4배 오버랩.
+  // 기타 화음의 인접 음(수십 Hz 간격)을 분리하려면 이 정도 해상도가 필요합니다.
+  static constexpr double frameSeconds = 0.085;
+  static constexpr int overlap = 4;
+  int fftSize = 0;
+  int hopSize = 0;
+  int numBins = 0;
+  int frameFill = 0;
+
+  // 프레임마다 그 프레임이 완성되는 샘플의 램프 값을 비율로 씁니다.
+  PitchRamp pitch;
+  float pitchRatio = 1.0f;
+
+  // 포먼트 보존: 같은 분석 프레임의 켑스트럼으로 스펙트럼 포락선을 구해
+  // 시프트 전에 나누고(평탄화) 시프트 후 원래 위치에 다시 곱합니다.
+  // 리프터는 약 1 ms 이하의 켑스트럼만 남겨 1 kHz 이하 기본음의
+  // 배음 구조는 포락선에 섞이지 않습니다.
+  bool formantPreservation = false;
+  int lifterLength = 0;
+  static constexpr double lifterSeconds = 0.001;
+
+  std::unique_ptr<juce::dsp::FFT> fft;
+  juce::HeapBlock<float> analysisWindow;
+  juce::HeapBlock<float> synthesisWindow; // 오버랩 합 정규화 포함
+
+  // 채널별 상태
+  juce::AudioBuffer<float> inputFrames;  // 최근 fftSize 입력
+  juce::AudioBuffer<float> outputAccum;  // 오버랩-애드 누산
+  juce::AudioBuffer<float> outputReady;  // 완성된 다음 홉 출력
+  juce::AudioBuffer<float> lastPhase;    // 직전 분석 위상
+  juce::AudioBuffer<float> synthPhase;   // 출력 빈별 합성 위상 누산
+
+  // 프레임 작업 영역 (채널 간 공유)
+  juce::HeapBlock<float> fftData; // 2 * fftSize
+  juce::HeapBlock<float> magnitude;
+  juce::HeapBlock<float> phase;
+  juce::HeapBlock<float> phaseAdvance; // 홉당 실제 위상 진행량
+  juce::HeapBlock<float> shiftedMagnitude;
+  juce::HeapBlock<float> shiftedPhase;
+  juce::HeapBlock<float> envelope;
+  juce::HeapBlock<int> peaks;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralShifter)
+};
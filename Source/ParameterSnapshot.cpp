@@ -0,0 +1,138 @@
+#include "ParameterSnapshot.h"
+
+juce::uint32
+ParameterSnapshot::getChanges(const ParameterSnapshot &previous) const {
+  juce::uint32 changes = 0;
+
+  // 값을 그대로 복사해 온 스냅샷끼리라 정확히 같은지만 봅니다.
+  auto differs = [](float a, float b) { return !juce::exactlyEqual(a, b); };
+
+  if (differs(pitch, previous.pitch))
+    changes |= pitchGroup;
+
+  if (differs(mix, previous.mix))
+    changes |= mixGroup;
+
+  if (bypass != previous.bypass)
+    changes |= bypassGroup;
+
+  if (engine != previous.engine)
+    changes |= engineGroup;
+
+  if (lowLatency != previous.lowLatency)
+    changes |= latencyGroup;
+
+  if (quality != previous.quality || grainHeads != previous.grainHeads ||
+      windowShape != previous.windowShape ||
+      differs(grainMs, previous.grainMs) || splice != previous.splice ||
+      adaptive != previous.adaptive || differs(transient, previous.transient))
+    changes |= grainGroup;
+
+  if (formant != previous.formant ||
+      differs(formantShift, previous.formantShift))
+    changes |= formantGroup;
+
+  if (midiControl != previous.midiControl || rootNote != previous.rootNote ||
+      differs(glideMs, previous.glideMs) || legato != previous.legato ||
+      expressionSource != previous.expressionSource ||
+      expressionController != previous.expressionController ||
+      expressionCurve != previous.expressionCurve ||
+      differs(heel, previous.heel) || differs(toe, previous.toe))
+    changes |= midiGroup;
+
+  if (harmonyVoices != previous.harmonyVoices)
+    changes |= harmonyGroup;
+
+  for (int v = 0; v < harmonyVoices; ++v) {
+    const auto &a = voices[(size_t)v];
+    const auto &b = previous.voices[(size_t)v];
+
+    if (differs(a.interval, b.interval) || differs(a.level, b.level) ||
+        differs(a.pan, b.pan))
+      changes |= harmonyGroup;
+  }
+
+  return changes;
+}
+
+ParameterHandles::ParameterHandles(juce::AudioProcessorValueTreeState &apvts) {
+  auto find = [&](const juce::String &id) {
+    auto *value = apvts.getRawParameterValue(id);
+    jassert(value != nullptr);
+    return value;
+  };
+
+  pitch = find("PITCH");
+  mix = find("MIX");
+  bypass = find("BYPASS");
+  engine = find("ENGINE");
+  latency = find("LATENCY");
+
+  quality = find("QUALITY");
+  grains = find("GRAINS");
+  window = find("WINDOW");
+  grain = find("GRAIN");
+  splice = find("SPLICE");
+  adaptive = find("ADAPTIVE");
+  transient = find("TRANSIENT");
+
+  formant = find("FORMANT");
+  formantShift = find("FORMANTSHIFT");
+
+  midiPitch = find("MIDIPITCH");
+  root = find("ROOT");
+  glide = find("GLIDE");
+  legato = find("LEGATO");
+  expression = find("EXPRESSION");
+  expressionController = find("EXPRCC");
+  curve = find("CURVE");
+  heel = find("HEEL");
+  toe = find("TOE");
+
+  voiceCount = find("VOICES");
+
+  for (int v = 0; v < PitchShifter::maxHarmonyVoices; ++v) {
+    const juce::String id = "VOICE" + juce::String(v + 1);
+    voices[(size_t)v] = {find(id), find(id + "LEVEL"), find(id + "PAN")};
+  }
+}
+
+ParameterSnapshot ParameterHandles::read() const {
+  ParameterSnapshot s;
+
+  s.pitch = *pitch;
+  s.mix = *mix;
+  s.bypass = *bypass > 0.5f;
+  s.engine = (int)*engine;
+  s.lowLatency = (int)*latency == 0;
+
+  s.quality = (InterpolationQuality)(int)*quality;
+  s.grainHeads = grainHeadCounts[(size_t)(int)*grains];
+  s.windowShape = (WindowShape)(int)*window;
+  s.grainMs = *grain;
+  s.splice = *splice > 0.5f;
+  s.adaptive = *adaptive > 0.5f;
+  s.transient = *transient;
+
+  s.formant = *formant > 0.5f;
+  s.formantShift = *formantShift;
+
+  s.midiControl = *midiPitch > 0.5f;
+  s.rootNote = (int)*root;
+  s.glideMs = *glide;
+  s.legato = *legato > 0.5f;
+  s.expressionSource = (MidiPitchControl::ExpressionSource)(int)*expression;
+  s.expressionController = (int)*expressionController;
+  s.expressionCurve = (MidiPitchControl::ExpressionCurve)(int)*curve;
+  s.heel = *heel;
+  s.toe = *toe;
+
+  s.harmonyVoices = (int)*voiceCount;
+
+  for (int v = 0; v < s.harmonyVoices; ++v) {
+    const auto &handles = voices[(size_t)v];
+    s.voices[(size_t)v] = {*handles[0], *handles[1], *handles[2]};
+  }
+
+  return s;
+}
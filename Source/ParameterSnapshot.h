@@ -0,0 +1,95 @@
+#pragma once
+
+#include "DSP/GrainWindows.h"
+#include "DSP/Interpolators.h"
+#include "DSP/MidiPitchControl.h"
+#include "DSP/PitchShifter.h"
+#include <JuceHeader.h>
+
+// 오디오 스레드가 블록마다 한 번 읽어 두는 파라미터 값 묶음.
+// 복사만으로 주고받을 수 있도록 단순 값 타입으로만 구성합니다.
+// 이전 블록의 스냅샷과 비교해 바뀐 그룹만 DSP 쪽 파생 값(비율, 게인,
+// 윈도우 테이블 등)을 다시 계산하게 합니다.
+struct ParameterSnapshot {
+  // 바뀐 파라미터 그룹 플래그
+  enum Group : juce::uint32 {
+    pitchGroup = 1 << 0,
+    mixGroup = 1 << 1,
+    bypassGroup = 1 << 2,
+    engineGroup = 1 << 3,
+    grainGroup = 1 << 4,
+    formantGroup = 1 << 5,
+    midiGroup = 1 << 6,
+    harmonyGroup = 1 << 7,
+    latencyGroup = 1 << 8,
+    allGroups = (1 << 9) - 1
+  };
+
+  struct HarmonyVoice {
+    float interval = 0.0f;
+    float level = 0.0f;
+    float pan = 0.0f;
+  };
+
+  float pitch = 0.0f;
+  float mix = 1.0f;
+  bool bypass = false;
+  int engine = 0;
+  bool lowLatency = false;
+
+  InterpolationQuality quality = InterpolationQuality::linear;
+  int grainHeads = 2;
+  WindowShape windowShape = WindowShape::triangle;
+  float grainMs = 45.0f;
+  bool splice = false;
+  bool adaptive = false;
+  float transient = 0.0f;
+
+  bool formant = false;
+  float formantShift = 0.0f;
+
+  bool midiControl = false;
+  int rootNote = 60;
+  float glideMs = 0.0f;
+  bool legato = true;
+  MidiPitchControl::ExpressionSource expressionSource =
+      MidiPitchControl::ExpressionSource::off;
+  int expressionController = 11;
+  MidiPitchControl::ExpressionCurve expressionCurve =
+      MidiPitchControl::ExpressionCurve::linear;
+  float heel = 0.0f;
+  float toe = 12.0f;
+
+  int harmonyVoices = 0;
+  std::array<HarmonyVoice, PitchShifter::maxHarmonyVoices> voices{};
+
+  // previous 와 비교해 값이 달라진 그룹의 플래그 합
+  juce::uint32 getChanges(const ParameterSnapshot &previous) const;
+};
+
+static_assert(std::is_trivially_copyable<ParameterSnapshot>::value,
+              "snapshots are copied by value on the audio thread");
+
+// APVTS 파라미터 값 포인터를 생성 시점에 한 번만 찾아 둡니다.
+// 오디오 스레드에서는 문자열 ID 검색 없이 원자 값만 읽습니다.
+class ParameterHandles {
+public:
+  explicit ParameterHandles(juce::AudioProcessorValueTreeState &apvts);
+
+  ParameterSnapshot read() const;
+
+private:
+  std::atomic<float> *pitch, *mix, *bypass, *engine, *latency;
+  std::atomic<float> *quality, *grains, *window, *grain, *splice, *adaptive,
+      *transient;
+  std::atomic<float> *formant, *formantShift;
+  std::atomic<float> *midiPitch, *root, *glide, *legato, *expression,
+      *expressionController, *curve, *heel, *toe;
+  std::atomic<float> *voiceCount;
+
+  // 하모니 보이스별 {음정, 레벨, 팬}
+  std::array<std::array<std::atomic<float> *, 3>, PitchShifter::maxHarmonyVoices>
+      voices{};
+
+  JUCE_DECLARE_NON_COPYABLE(ParameterHandles)
+};
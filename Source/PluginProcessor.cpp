@@ -8,10 +8,10 @@ YAMMYAudioProcessor::YAMMYAudioProcessor()
               .withInput("Input", juce::AudioChannelSet::stereo(), true)
               .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
 #endif
-      apvts(*this, nullptr, "Parameters", createParameterLayout()) {
-}
+      apvts(*this, nullptr, "Parameters", createParameterLayout()),
+      parameterHandles(apvts), bypassParameter(apvts.getParameter("BYPASS")) {}
 
-YAMMYAudioProcessor::~YAMMYAudioProcessor() {}
+YAMMYAudioProcessor::~YAMMYAudioProcessor() { cancelPendingUpdate(); }
 
 juce::AudioProcessorValueTreeState::ParameterLayout
 YAMMYAudioProcessor::createParameterLayout() {
@@ -23,6 +23,95 @@ YAMMYAudioProcessor::createParameterLayout() {
                                                          1.0f, 1.0f));
   layout.add(
       std::make_unique<juce::AudioParameterBool>("BYPASS", "Bypass", false));
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "ENGINE", "Engine", juce::StringArray{"Grain", "Spectral", "PSOLA", "Auto", "Multiband"},
+      0));
+  // Low: 짧은 고정 그레인의 그레인 엔진 (5 ms 미만), High Quality: 위 설정 그대로
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "LATENCY", "Latency Mode", juce::StringArray{"Low", "High Quality"}, 1));
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "QUALITY", "Interpolation",
+      juce::StringArray{"Linear", "Hermite", "Lagrange 4", "Lagrange 6",
+                        "Sinc"},
+      0));
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "GRAINS", "Grain Heads", juce::StringArray{"2", "3", "4", "8"}, 0));
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "WINDOW", "Grain Window", juce::StringArray{"Triangle", "Hann", "Tukey"},
+      0));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "GRAIN", "Grain Length",
+      juce::NormalisableRange<float>(PitchShifter::minGrainMs,
+                                     PitchShifter::maxGrainMs, 0.1f, 0.5f),
+      45.0f, juce::AudioParameterFloatAttributes().withLabel("ms")));
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "SPLICE", "Splice Align", false));
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "ADAPTIVE", "Adaptive Grain", false));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "TRANSIENT", "Transient Sensitivity", 0.0f, 1.0f, 0.0f));
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "FORMANT", "Formant Preserve", false));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "FORMANTSHIFT", "Formant Shift",
+      juce::NormalisableRange<float>(-PsolaShifter::maxFormantShift,
+                                     PsolaShifter::maxFormantShift, 0.01f),
+      0.0f, juce::AudioParameterFloatAttributes().withLabel("st")));
+
+  // MIDI 노트 음정 제어
+  layout.add(std::make_unique<juce::AudioParameterBool>(
+      "MIDIPITCH", "MIDI Pitch", false));
+  layout.add(std::make_unique<juce::AudioParameterInt>("ROOT", "Root Note", 0,
+                                                       127, 60));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "GLIDE", "Glide",
+      juce::NormalisableRange<float>(0.0f, 2000.0f, 0.1f, 0.3f), 0.0f,
+      juce::AudioParameterFloatAttributes().withLabel("ms")));
+  layout.add(
+      std::make_unique<juce::AudioParameterBool>("LEGATO", "Legato", true));
+
+  // 익스프레션 페달 (MIDI CC 또는 피치 벤드)
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "EXPRESSION", "Expression",
+      juce::StringArray{"Off", "CC", "Pitch Bend"}, 0));
+  layout.add(std::make_unique<juce::AudioParameterInt>(
+      "EXPRCC", "Expression CC", 0, 127, 11));
+  layout.add(std::make_unique<juce::AudioParameterChoice>(
+      "CURVE", "Expression Curve",
+      juce::StringArray{"Linear", "Exponential", "Logarithmic", "S-Curve"},
+      0));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "HEEL", "Heel Pitch",
+      juce::NormalisableRange<float>(-MidiPitchControl::maxInterval,
+                                     MidiPitchControl::maxInterval, 0.01f),
+      0.0f, juce::AudioParameterFloatAttributes().withLabel("st")));
+  layout.add(std::make_unique<juce::AudioParameterFloat>(
+      "TOE", "Toe Pitch",
+      juce::NormalisableRange<float>(-MidiPitchControl::maxInterval,
+                                     MidiPitchControl::maxInterval, 0.01f),
+      12.0f, juce::AudioParameterFloatAttributes().withLabel("st")));
+
+  // 하모니 보이스 (그레인 엔진). 기본 음정은 3도/5도/옥타브 위주로 둡니다.
+  static constexpr std::array<float, PitchShifter::maxHarmonyVoices>
+      defaultIntervals{4.0f, 7.0f, 12.0f, -12.0f, 3.0f, 5.0f, 10.0f, -5.0f};
+
+  layout.add(std::make_unique<juce::AudioParameterInt>(
+      "VOICES", "Harmony Voices", 0, PitchShifter::maxHarmonyVoices, 0));
+
+  for (int v = 0; v < PitchShifter::maxHarmonyVoices; ++v) {
+    const juce::String id = "VOICE" + juce::String(v + 1);
+    const juce::String name = "Voice " + juce::String(v + 1);
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        id, name + " Interval",
+        juce::NormalisableRange<float>(-24.0f, 24.0f, 1.0f),
+        defaultIntervals[(size_t)v],
+        juce::AudioParameterFloatAttributes().withLabel("st")));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        id + "LEVEL", name + " Level", 0.0f, 1.0f, 0.7f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        id + "PAN", name + " Pan", -1.0f, 1.0f, 0.0f));
+  }
 
   return layout;
 }
@@ -55,7 +144,10 @@ bool YAMMYAudioProcessor::isMidiEffect() const {
 #endif
 }
 
-double YAMMYAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double YAMMYAudioProcessor::getTailLengthSeconds() const {
+  const double sampleRate = getSampleRate();
+  return sampleRate > 0.0 ? tailSamples.load() / sampleRate : 0.0;
+}
 
 int YAMMYAudioProcessor::getNumPrograms() {
   return 1; // 참고: 일부 호스트는 프로그램이 0개라고 알리면 잘 처리하지
@@ -74,7 +166,123 @@ void YAMMYAudioProcessor::changeProgramName(int index,
 
 void YAMMYAudioProcessor::prepareToPlay(double sampleRate,
                                         int samplesPerBlock) {
-  pitchShifter.prepare(sampleRate, samplesPerBlock);
+  // 준비 직후 첫 블록에서 모든 파라미터를 다시 넘기도록 표시해 둡니다.
+  parameters = parameterHandles.read();
+  pendingChanges = ParameterSnapshot::allGroups;
+  engineSwitchPending = false;
+  engineResetPending = false;
+
+  // 엔진 히스토리는 버스 레이아웃의 채널 수만큼만 잡습니다 (모노면 절반).
+  // 선택된 엔진만 여기서 준비하고, 다른 엔진은 처음 선택될 때 준비합니다.
+  const int numChannels = getTotalNumOutputChannels();
+  {
+    const juce::ScopedLock lock(prepareLock);
+    cancelPendingUpdate();
+    engineSpec = {sampleRate, (juce::uint32)samplesPerBlock,
+                  (juce::uint32)numChannels};
+
+    for (auto &prepared : enginePrepared)
+      prepared.store(false, std::memory_order_release);
+
+    prepareEngine(getSelectedEngine());
+    enginesAdded = false;
+  }
+
+  pitchDetector.prepare(sampleRate, samplesPerBlock);
+  midiPitch.setFallback(parameters.pitch);
+  midiPitch.setExpressionRange(parameters.heel, parameters.toe);
+  midiPitch.setExpressionSource(parameters.expressionSource);
+  midiPitch.prepare(sampleRate);
+
+  activeEngine = &getEngine(getSelectedEngine());
+  setLatencySamples(activeEngine->getLatencySamples());
+  tailSamples = activeEngine->getTailSamples();
+  silenceDetector.reset();
+
+  // 원음 딜레이 라인과 믹스 버퍼는 여기서 한 번만 할당합니다.
+  // 오디오 스레드에서는 더 이상 힙 할당이 일어나지 않습니다.
+  // 딜레이 라인은 아직 준비하지 않은 엔진으로 바꿔도 되도록 엔진 공통
+  // 레이턴시 상한만큼 잡습니다.
+  dryWetMixer = juce::dsp::DryWetMixer<float>(
+      (int)std::ceil(sampleRate * PitchEngine::maxLatencySeconds));
+  dryWetMixer.setMixingRule(juce::dsp::DryWetMixingRule::linear);
+  dryWetMixer.prepare({sampleRate, (juce::uint32)samplesPerBlock,
+                       (juce::uint32)numChannels});
+  wetLatency = activeEngine->getLatencySamples();
+  dryWetMixer.setWetLatency((float)wetLatency);
+
+  // 준비 직후에는 믹서 볼륨이 자리잡을 때까지 바이패스 중이어도 엔진을
+  // 돌립니다.
+  bypassFadeSamples = (int)std::ceil(sampleRate * bypassFadeSeconds);
+  bypassFadeRemaining = bypassFadeSamples;
+  engineWarm = true;
+  warmupRemaining = 0;
+}
+
+void YAMMYAudioProcessor::prepareEngine(int engine) {
+  // prepareLock 을 잡은 채로 부릅니다. 자동 엔진은 그레인/스펙트럼 엔진을
+  // 감싸므로 둘을 먼저 준비합니다.
+  if (engine == autoEngine) {
+    prepareEngine(grainEngine);
+    prepareEngine(spectralEngine);
+  }
+
+  if (isEnginePrepared(engine))
+    return;
+
+  // 그레인 상한(레이턴시)은 준비 전에 정해 두어, 오디오 스레드가 전환할 때
+  // 보고하는 레이턴시가 곧바로 맞게 합니다. 나머지 설정은 준비가 끝난 뒤
+  // 오디오 스레드가 다시 넘깁니다.
+  if (engine == grainEngine) {
+    const auto p = parameterHandles.read();
+    pitchShifter.setGrainLength(p.lowLatency ? lowLatencyGrainMs : p.grainMs);
+    pitchShifter.setGrainLengthLimit(p.lowLatency ? lowLatencyGrainMs
+                                                  : PitchShifter::maxGrainMs);
+  }
+
+  getEngine(engine).prepare(engineSpec.sampleRate,
+                            (int)engineSpec.maximumBlockSize,
+                            (int)engineSpec.numChannels);
+  enginePrepared[(size_t)engine].store(true, std::memory_order_release);
+}
+
+void YAMMYAudioProcessor::handleAsyncUpdate() {
+  const juce::ScopedLock lock(prepareLock);
+
+  // prepareToPlay 전이면 준비할 형식을 아직 모릅니다.
+  if (engineSpec.maximumBlockSize == 0)
+    return;
+
+  const int engine = requestedEngine.load();
+  if (!isEnginePrepared(engine)) {
+    prepareEngine(engine);
+    enginesAdded = true;
+  }
+}
+
+float YAMMYAudioProcessor::getGrainLengthLimit() const {
+  return parameters.lowLatency ? lowLatencyGrainMs : PitchShifter::maxGrainMs;
+}
+
+int YAMMYAudioProcessor::getSelectedEngine() const {
+  return parameters.lowLatency ? grainEngine
+                               : juce::jlimit(0, numEngines - 1,
+                                              parameters.engine);
+}
+
+PitchEngine &YAMMYAudioProcessor::getEngine(int engine) {
+  switch (engine) {
+  case spectralEngine:
+    return spectralShifter;
+  case psolaEngine:
+    return psolaShifter;
+  case autoEngine:
+    return hybridEngine;
+  case multibandEngine:
+    return multibandShifter;
+  default:
+    return pitchShifter;
+  }
 }
 
 void YAMMYAudioProcessor::releaseResources() {}
@@ -111,30 +319,241 @@ void YAMMYAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
     buffer.clear(i, 0, buffer.getNumSamples());
 
   // 파라미터 업데이트
-  float pitch = *apvts.getRawParameterValue("PITCH");
-  float mix = *apvts.getRawParameterValue("MIX");
-  bool bypass = *apvts.getRawParameterValue("BYPASS") > 0.5f;
+  // 블록마다 한 번 스냅샷을 읽고, 바뀐 그룹만 DSP 에 다시 넘깁니다.
+  const auto next = parameterHandles.read();
+  // 메시지 스레드가 엔진을 새로 준비했으면 그 엔진에 설정을 다시 넘깁니다.
+  const auto changes =
+      next.getChanges(parameters) | std::exchange(pendingChanges, 0u) |
+      (enginesAdded.exchange(false) ? engineSettingGroups : 0u);
+  parameters = next;
+  const auto &p = parameters;
+
+  if (changes & (ParameterSnapshot::grainGroup | ParameterSnapshot::latencyGroup)) {
+    if (isEnginePrepared(grainEngine)) {
+      pitchShifter.setInterpolationQuality(p.quality);
+      pitchShifter.setGrainHeads(p.grainHeads);
+      pitchShifter.setWindowShape(p.windowShape);
+      // GRAIN 은 상한 안에서 길이만 램프하므로 레이턴시가 그대로입니다.
+      // 상한(레이턴시)은 레이턴시 모드로만 바뀌고, 그때는 아래에서 엔진을
+      // 비우고 호스트에 새 레이턴시를 알립니다.
+      pitchShifter.setGrainLength(p.lowLatency ? lowLatencyGrainMs : p.grainMs);
+      pitchShifter.setGrainLengthLimit(getGrainLengthLimit());
+      pitchShifter.setSpliceAlignment(p.splice && !p.lowLatency);
+      pitchShifter.setAdaptiveGrain(p.adaptive && !p.lowLatency);
+      pitchShifter.setTransientSensitivity(p.transient);
+    }
+
+    if (isEnginePrepared(multibandEngine)) {
+      multibandShifter.setInterpolationQuality(p.quality);
+      multibandShifter.setGrainHeads(p.grainHeads);
+      multibandShifter.setWindowShape(p.windowShape);
+    }
+  }
+
+  // 엔진이 바뀌면 새 엔진을 비우고 호스트에 레이턴시를 다시 알립니다.
+  // 레이턴시 모드가 바뀌면 같은 엔진이어도 그레인 설정이 달라지므로
+  // 엔진을 비우고 새 레이턴시를 알립니다 (reset 은 그레인 길이 램프도 끝냅니다).
+  // 새 엔진이 아직 준비되지 않았으면 준비를 맡기고 다음 블록에 다시 봅니다.
+  if (changes & (ParameterSnapshot::engineGroup | ParameterSnapshot::latencyGroup))
+    engineSwitchPending = true;
+
+  if (changes & ParameterSnapshot::latencyGroup)
+    engineResetPending = true;
+
+  if (engineSwitchPending) {
+    const int selected = getSelectedEngine();
+
+    if (isEnginePrepared(selected)) {
+      auto &selectedEngine = getEngine(selected);
+
+      if (&selectedEngine != activeEngine || engineResetPending) {
+        selectedEngine.reset();
+        activeEngine = &selectedEngine;
+        setLatencySamples(activeEngine->getLatencySamples());
+        tailSamples = activeEngine->getTailSamples();
+      }
+
+      engineSwitchPending = false;
+      engineResetPending = false;
+    } else {
+      requestedEngine = selected;
+      triggerAsyncUpdate();
+    }
+  }
 
-  if (bypass)
+  if (changes & ParameterSnapshot::pitchGroup)
+    midiPitch.setFallback(p.pitch);
+
+  if (changes & ParameterSnapshot::midiGroup) {
+    midiPitch.setRootNote(p.rootNote);
+    midiPitch.setGlideTime(p.glideMs);
+    midiPitch.setLegato(p.legato);
+    midiPitch.setNoteControl(p.midiControl);
+    midiPitch.setExpressionController(p.expressionController);
+    midiPitch.setExpressionCurve(p.expressionCurve);
+    midiPitch.setExpressionRange(p.heel, p.toe);
+    midiPitch.setExpressionSource(p.expressionSource);
+  }
+
+  if ((changes & ParameterSnapshot::harmonyGroup) &&
+      isEnginePrepared(grainEngine)) {
+    pitchShifter.setHarmonyVoiceCount(p.harmonyVoices);
+    for (int v = 0; v < p.harmonyVoices; ++v) {
+      const auto &voice = p.voices[(size_t)v];
+      pitchShifter.setHarmonyVoice(v, voice.interval, voice.level, voice.pan);
+    }
+  }
+
+  if (changes & ParameterSnapshot::formantGroup) {
+    if (isEnginePrepared(spectralEngine))
+      spectralShifter.setFormantPreservation(p.formant);
+    if (isEnginePrepared(psolaEngine))
+      psolaShifter.setFormantShift(p.formantShift);
+  }
+
+  // 바이패스는 웻 비율을 0 으로 내리는 것으로 처리해, 믹서의 볼륨 램프가
+  // 레이턴시가 맞춰진 원음과의 크로스페이드가 되게 합니다.
+  if (changes & (ParameterSnapshot::mixGroup | ParameterSnapshot::bypassGroup))
+    dryWetMixer.setWetMixProportion(p.bypass || warmupRemaining > 0 ? 0.0f
+                                                                    : p.mix);
+
+  if (changes & ParameterSnapshot::bypassGroup)
+    bypassFadeRemaining = bypassFadeSamples;
+
+  const int numSamples = buffer.getNumSamples();
+
+  // 엔진 슬립: 입력이 엔진 꼬리(원음 지연보다 깁니다)보다 오래 무음이면
+  // 이 블록의 출력은 모두 0 이므로 엔진, 피치 검출, 믹서를 모두 건너뜁니다.
+  // 엔진과 원음 딜레이 라인에는 무음만 남아 있어 그대로 멈춰 두었다가
+  // 소리가 들어오면 이어서 처리합니다.
+  silenceDetector.process(buffer, totalNumInputChannels);
+
+  if (silenceDetector.getSilentSamples() >=
+      numSamples + activeEngine->getTailSamples()) {
+    buffer.clear();
+    followMidi(midiMessages, numSamples);
     return;
+  }
 
   // 피치 시프팅 처리
-  // 믹스를 위해 원음(Dry) 복사본이 필요합니다.
-  juce::AudioBuffer<float> dryBuffer;
-  dryBuffer.makeCopyOf(buffer);
+  // 원음(Dry)은 믹서 내부의 미리 할당된 딜레이 라인으로 보내
+  // 엔진 레이턴시만큼 지연시킨 뒤 웻 신호와 섞습니다.
+  juce::dsp::AudioBlock<float> block(buffer);
+
+  // 원음 딜레이는 엔진 레이턴시가 실제로 바뀔 때만 옮깁니다. Thiran 보간
+  // 딜레이는 값이 바뀔 때마다 튀므로 블록마다 다시 설정하지 않습니다.
+  // 엔진 레이턴시는 엔진이나 레이턴시 모드를 바꿀 때만 달라지며, 호스트에는
+  // 위에서 이미 알렸습니다.
+  if (activeEngine->getLatencySamples() != wetLatency) {
+    wetLatency = activeEngine->getLatencySamples();
+    dryWetMixer.setWetLatency((float)wetLatency);
+  }
 
-  pitchShifter.setPitch(pitch);
-  pitchShifter.process(buffer);
+  dryWetMixer.pushDrySamples(block);
 
-  // Dry/Wet 믹스
-  for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
-    auto *dry = dryBuffer.getReadPointer(channel);
-    auto *wet = buffer.getWritePointer(channel);
+  // 페이드아웃이 끝나면 엔진과 피치 검출을 건너뛰고, 엔진 히스토리만
+  // 이어 둡니다. 웻 게인이 0 이므로 출력은 지연된 원음입니다.
+  // 노트 오프를 놓치지 않도록 MIDI 상태는 계속 따라갑니다.
+  if (p.bypass && bypassFadeRemaining == 0) {
+    engineWarm = activeEngine->keepWarm(buffer);
+    warmupRemaining = 0;
+    followMidi(midiMessages, numSamples);
+    dryWetMixer.mixWetSamples(block);
+    return;
+  }
+
+  if (p.bypass)
+    bypassFadeRemaining = juce::jmax(0, bypassFadeRemaining - numSamples);
+
+  // 히스토리를 이어 둘 수 없는 엔진은 재개 전에 비우고, 레이턴시만큼 다시
+  // 채울 때까지 웻을 0 에 둡니다. 그러지 않으면 원음이 빠지는 동안 웻은
+  // 아직 무음이라 크로스페이드가 무음 위에서 일어납니다.
+  if (!engineWarm) {
+    activeEngine->reset();
+    engineWarm = true;
+    warmupRemaining = activeEngine->getLatencySamples();
+    dryWetMixer.setWetMixProportion(0.0f);
+  }
 
-    for (int i = 0; i < buffer.getNumSamples(); ++i) {
-      wet[i] = dry[i] * (1.0f - mix) + wet[i] * mix;
+  // 시프팅 전 입력을 분석합니다 (고정 홉마다 한 번씩 FFT 수행).
+  // 검출 결과는 파라미터와 무관하게 블록마다 바뀝니다.
+  pitchDetector.process(buffer);
+
+  if (isEnginePrepared(grainEngine))
+    pitchShifter.setDetectedPeriod(pitchDetector.getPeriodSamples(),
+                                   pitchDetector.getConfidence());
+  if (isEnginePrepared(psolaEngine))
+    psolaShifter.setDetectedPeriod(pitchDetector.getPeriodSamples(),
+                                   pitchDetector.getConfidence());
+  if (isEnginePrepared(autoEngine))
+    hybridEngine.setPeriodicity(pitchDetector.getClarity());
+
+  // MIDI 이벤트 시점에서 블록을 나눠 음정을 샘플 단위로 정확하게 바꿉니다.
+  // 노트 제어와 페달이 모두 꺼져 있으면 이벤트를 무시하고 블록 전체를 한 번에
+  // 처리합니다. 이벤트 사이의 글라이드와 스무딩은 엔진이 램프를 샘플마다
+  // 따라가므로 더 나눌 필요가 없습니다.
+  int position = 0;
+  syncEnginePitch();
+
+  if (p.midiControl ||
+      p.expressionSource != MidiPitchControl::ExpressionSource::off) {
+    for (const auto metadata : midiMessages) {
+      const int eventPosition =
+          juce::jlimit(position, numSamples, metadata.samplePosition);
+      processEngine(buffer, position, eventPosition);
+      midiPitch.handleMessage(metadata.getMessage());
+      syncEnginePitch();
+      position = eventPosition;
     }
   }
+
+  processEngine(buffer, position, numSamples);
+
+  // Dry/Wet 믹스 (FloatVectorOperations 기반 블록 연산)
+  dryWetMixer.mixWetSamples(block);
+
+  // 엔진이 레이턴시만큼 입력을 받았으면 다음 블록부터 웻을 페이드인합니다.
+  if (warmupRemaining > 0) {
+    warmupRemaining = juce::jmax(0, warmupRemaining - numSamples);
+
+    if (warmupRemaining == 0 && !p.bypass)
+      dryWetMixer.setWetMixProportion(p.mix);
+  }
+}
+
+void YAMMYAudioProcessor::followMidi(const juce::MidiBuffer &midiMessages,
+                                     int numSamples) {
+  for (const auto metadata : midiMessages)
+    midiPitch.handleMessage(metadata.getMessage());
+
+  midiPitch.advance(numSamples);
+}
+
+void YAMMYAudioProcessor::processEngine(juce::AudioBuffer<float> &buffer,
+                                        int startSample, int endSample) {
+  const int numSamples = endSample - startSample;
+  if (numSamples <= 0)
+    return;
+
+  juce::AudioBuffer<float> segment(buffer.getArrayOfWritePointers(),
+                                   buffer.getNumChannels(), startSample,
+                                   numSamples);
+
+  activeEngine->process(segment);
+  midiPitch.advance(numSamples);
+}
+
+void YAMMYAudioProcessor::syncEnginePitch() {
+  // 엔진은 같은 램프를 샘플마다 따라가고 블록 단위로 같이 진행하므로,
+  // 블록 시작(엔진 전환/리셋 뒤 포함)과 음정을 바꾸는 이벤트 뒤에만
+  // 맞추면 됩니다.
+  const auto &ramp = midiPitch.getRamp();
+  activeEngine->setPitch(ramp.getCurrentValue(), 0);
+  activeEngine->setPitch(ramp.getTargetValue(), ramp.getRemainingSamples());
+}
+
+juce::AudioProcessorParameter *YAMMYAudioProcessor::getBypassParameter() const {
+  return bypassParameter;
 }
 
 bool YAMMYAudioProcessor::hasEditor() const {
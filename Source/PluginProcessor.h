@@ -1,9 +1,18 @@
 #pragma once
 
+#include "DSP/HybridEngine.h"
+#include "DSP/MidiPitchControl.h"
+#include "DSP/MultibandShifter.h"
+#include "DSP/PitchDetector.h"
 #include "DSP/PitchShifter.h"
+#include "DSP/PsolaShifter.h"
+#include "DSP/SilenceDetector.h"
+#include "DSP/SpectralShifter.h"
+#include "ParameterSnapshot.h"
 #include <JuceHeader.h>
 
-class YAMMYAudioProcessor : public juce::AudioProcessor {
+class YAMMYAudioProcessor : public juce::AudioProcessor,
+                            private juce::AsyncUpdater {
 public:
   YAMMYAudioProcessor();
   ~YAMMYAudioProcessor() override;
@@ -17,6 +26,9 @@ public:
 
   void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
 
+  // 호스트 바이패스를 BYPASS 파라미터로 받아 플러그인 안에서 크로스페이드합니다.
+  juce::AudioProcessorParameter *getBypassParameter() const override;
+
   juce::AudioProcessorEditor *createEditor() override;
   bool hasEditor() const override;
 
@@ -38,10 +50,103 @@ public:
 
   juce::AudioProcessorValueTreeState apvts;
 
+  // 입력 피치 검출 결과 (UI 스레드에서 잠금 없이 읽을 수 있습니다)
+  const PitchDetector &getPitchDetector() const { return pitchDetector; }
+
+  // 엔진 번호 (ENGINE 파라미터 선택지 순서와 같습니다)
+  enum Engine { grainEngine, spectralEngine, psolaEngine, autoEngine,
+                multibandEngine, numEngines };
+
+  // 엔진이 준비(할당)되었는지. 선택된 엔진만 준비되며, 나머지는 처음
+  // 선택될 때 메시지 스레드에서 준비됩니다.
+  bool isEnginePrepared(int engine) const {
+    return enginePrepared[(size_t)engine].load(std::memory_order_acquire);
+  }
+
 private:
   juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+  // 생성 시 찾아 둔 파라미터 값 포인터와 마지막으로 읽은 스냅샷.
+  // pendingChanges 는 아직 DSP 에 넘기지 않은 그룹입니다.
+  ParameterHandles parameterHandles;
+  ParameterSnapshot parameters;
+  juce::uint32 pendingChanges = ParameterSnapshot::allGroups;
+
+  juce::AudioProcessorParameter *bypassParameter = nullptr;
+
   PitchShifter pitchShifter;
+  SpectralShifter spectralShifter;
+  PsolaShifter psolaShifter;
+  HybridEngine hybridEngine{pitchShifter, spectralShifter};
+  MultibandShifter multibandShifter;
+  PitchDetector pitchDetector;
+  MidiPitchControl midiPitch;
+
+  // ENGINE 파라미터로 고른 현재 엔진 (저지연 모드에서는 항상 그레인 엔진).
+  // prepareToPlay 는 선택된 엔진만 준비합니다. 오디오 스레드에서는 할당할
+  // 수 없으므로, 준비되지 않은 엔진이 선택되면 메시지 스레드에 준비를
+  // 맡기고(handleAsyncUpdate) 끝날 때까지 이전 엔진을 계속 씁니다.
+  // 준비 중인 엔진에는 오디오 스레드가 손대지 않도록 설정도 준비된
+  // 엔진에만 넘기고, 준비가 끝나면 엔진 설정 그룹을 다시 넘깁니다.
+  PitchEngine *activeEngine = &pitchShifter;
+  int getSelectedEngine() const;
+  PitchEngine &getEngine(int engine);
+  void prepareEngine(int engine);
+  void handleAsyncUpdate() override;
+
+  std::array<std::atomic<bool>, numEngines> enginePrepared{};
+  std::atomic<int> requestedEngine{grainEngine};
+  std::atomic<bool> enginesAdded{false};
+  juce::CriticalSection prepareLock; // prepareToPlay 와 지연 준비 사이
+  juce::dsp::ProcessSpec engineSpec{44100.0, 0, 0};
+
+  // 엔진 전환이나 레이턴시 모드 변경이 아직 반영되지 않았는지
+  // (새 엔진이 준비되기를 기다리는 동안 유지됩니다)
+  bool engineSwitchPending = false;
+  bool engineResetPending = false;
+
+  // 엔진이 새로 준비되면 다시 넘기는 파라미터 그룹
+  static constexpr juce::uint32 engineSettingGroups =
+      ParameterSnapshot::grainGroup | ParameterSnapshot::harmonyGroup |
+      ParameterSnapshot::formantGroup;
+
+  // 저지연 모드의 그레인 길이이자 상한. 레이턴시는 반 그레인 + 보간
+  // 여유분이라 4 ms 에 몇 샘플을 더한 값으로 고정됩니다 (스플라이스/적응형은
+  // 끔). 고품질 모드의 상한은 PitchShifter::maxGrainMs 입니다.
+  // 상한은 레이턴시 모드로만 정하므로 GRAIN 자동화는 레이턴시를 바꾸지 않습니다.
+  static constexpr float lowLatencyGrainMs = 8.0f;
+  float getGrainLengthLimit() const;
+
+  // 블록의 [startSample, endSample) 구간을 처리하고 MIDI 음정 램프를
+  // 같은 만큼 진행시킵니다.
+  void processEngine(juce::AudioBuffer<float> &buffer, int startSample,
+                     int endSample);
+
+  // 활성 엔진의 음정 램프를 MIDI 쪽 램프(현재 값, 목표, 남은 길이)에 맞춥니다.
+  void syncEnginePitch();
+
+  // 엔진을 건너뛰는 블록에서도 노트/페달 상태는 따라갑니다.
+  void followMidi(const juce::MidiBuffer &midiMessages, int numSamples);
+
+  // 입력 무음 길이와 활성 엔진의 꼬리 길이 (getTailLengthSeconds 용)
+  SilenceDetector silenceDetector;
+  std::atomic<int> tailSamples{0};
+
+  // 원음 경로: prepareToPlay에서 미리 할당되고 엔진 레이턴시만큼 지연됩니다.
+  // wetLatency 는 마지막으로 믹서에 넘긴 레이턴시입니다.
+  juce::dsp::DryWetMixer<float> dryWetMixer;
+  int wetLatency = 0;
+
+  // 바이패스 크로스페이드: 믹서의 볼륨 램프(DryWetMixer 고정 50 ms)가
+  // 끝날 때까지는 엔진을 계속 돌리고, 그 뒤로는 엔진을 건너뜁니다.
+  // engineWarm 은 건너뛰는 동안 엔진 히스토리가 이어졌는지 여부이고,
+  // warmupRemaining 은 리셋한 엔진을 다시 채우는 동안 웻을 0 에 붙잡아 둘
+  // 남은 샘플 수입니다.
+  static constexpr double bypassFadeSeconds = 0.05;
+  int bypassFadeSamples = 0;
+  int bypassFadeRemaining = 0;
+  bool engineWarm = true;
+  int warmupRemaining = 0;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(YAMMYAudioProcessor)
 };
@@ -0,0 +1,251 @@
+#include "DSP/MultibandShifter.h"
+#include "DSP/PitchShifter.h"
+#include "DSP/PsolaShifter.h"
+#include "DSP/SpectralShifter.h"
+#include <JuceHeader.h>
+
+// 엔진 처리 비용 벤치마크 (콘솔).
+// 48 kHz 스테레오 220 Hz 사인을 +5 반음으로 시프트하면서 블록 크기별로
+// 샘플(프레임)당 평균 나노초를 잽니다. 항목마다 여러 번 돌려 가장 빠른
+// 값을 쓰므로, 다른 프로세스의 간섭보다 커널 자체의 비용에 가깝습니다.
+//
+// 사용법: YAMMYBenchmark [반복 횟수]
+namespace {
+constexpr double sampleRate = 48000.0;
+constexpr int numChannels = 2;
+constexpr double secondsPerRun = 2.0;
+constexpr float shiftSemitones = 5.0f;
+
+constexpr std::array<int, 7> blockSizes{32, 64, 128, 256, 512, 1024, 2048};
+
+// 한 항목: 이름과, 엔진을 만들어 설정까지 마치는 함수
+struct Case {
+  const char *name;
+  std::function<std::unique_ptr<PitchEngine>()> create;
+};
+
+template <typename Engine>
+Case makeCase(const char *name,
+              std::function<void(Engine &)> configure = nullptr) {
+  return {name, [configure] {
+            auto engine = std::make_unique<Engine>();
+            if (configure)
+              configure(*engine);
+            return std::unique_ptr<PitchEngine>(std::move(engine));
+          }};
+}
+
+// 하모니 보이스 v 의 음정 (반음)
+float voiceSemitones(int voice) { return 3.0f + 4.0f * (float)voice; }
+
+// 보이스마다 PitchShifter 를 따로 두는 구성 (플러그인 인스턴스를 보이스
+// 수만큼 띄운 것과 같음). 첫 인스턴스가 주 보이스이고, 인스턴스마다 입력
+// 사본을 처리해 더합니다. 한 시프터 안의 하모니 보이스와 비교하는 기준입니다.
+class SeparateShifters : public PitchEngine {
+public:
+  explicit SeparateShifters(int numVoices) : shifters((size_t)numVoices + 1) {
+    for (auto &s : shifters)
+      s.setHarmonyCapacity(0);
+  }
+
+  void prepare(double rate, int samplesPerBlock, int channels) override {
+    for (auto &s : shifters)
+      s.prepare(rate, samplesPerBlock, channels);
+
+    scratch.setSize(channels, samplesPerBlock);
+    sum.setSize(channels, samplesPerBlock);
+  }
+
+  void reset() override {
+    for (auto &s : shifters)
+      s.reset();
+  }
+
+  void setPitch(float semitones, int rampSamples) override {
+    shifters[0].setPitch(semitones, rampSamples);
+    for (size_t v = 1; v < shifters.size(); ++v)
+      shifters[v].setPitch(voiceSemitones((int)v - 1), rampSamples);
+  }
+
+  void process(juce::AudioBuffer<float> &buffer) override {
+    const int channels = buffer.getNumChannels();
+    const int numSamples = buffer.getNumSamples();
+    juce::AudioBuffer<float> copy(scratch.getArrayOfWritePointers(), channels,
+                                  numSamples);
+
+    for (size_t v = 0; v < shifters.size(); ++v) {
+      for (int ch = 0; ch < channels; ++ch)
+        copy.copyFrom(ch, 0, buffer, ch, 0, numSamples);
+
+      shifters[v].process(copy);
+
+      for (int ch = 0; ch < channels; ++ch) {
+        if (v == 0)
+          sum.copyFrom(ch, 0, copy, ch, 0, numSamples);
+        else
+          sum.addFrom(ch, 0, copy, ch, 0, numSamples, 0.5f);
+      }
+    }
+
+    for (int ch = 0; ch < channels; ++ch)
+      buffer.copyFrom(ch, 0, sum, ch, 0, numSamples);
+  }
+
+  int getLatencySamples() const override {
+    return shifters[0].getLatencySamples();
+  }
+  int getMaxLatencySamples() const override {
+    return shifters[0].getMaxLatencySamples();
+  }
+
+private:
+  std::vector<PitchShifter> shifters;
+  juce::AudioBuffer<float> scratch, sum;
+};
+
+juce::AudioBuffer<float> makeInput() {
+  const int numSamples = (int)(sampleRate * secondsPerRun);
+  juce::AudioBuffer<float> input(numChannels, numSamples);
+
+  for (int ch = 0; ch < numChannels; ++ch)
+    for (int i = 0; i < numSamples; ++i)
+      input.setSample(ch, i,
+                      0.5f * std::sin(juce::MathConstants<float>::twoPi *
+                                      220.0f * (float)i / (float)sampleRate));
+
+  return input;
+}
+
+// 입력 전체를 blockSize 단위로 처리하는 데 걸린 샘플당 최소 시간 (ns)
+double measure(PitchEngine &engine, const juce::AudioBuffer<float> &input,
+               int blockSize, int numRuns) {
+  const int numSamples = input.getNumSamples();
+  juce::AudioBuffer<float> work(numChannels, numSamples);
+
+  engine.prepare(sampleRate, blockSize, numChannels);
+  engine.setPitch(shiftSemitones);
+
+  double best = std::numeric_limits<double>::max();
+
+  for (int run = 0; run < numRuns; ++run) {
+    work.makeCopyOf(input, true);
+    engine.reset();
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    for (int offset = 0; offset < numSamples; offset += blockSize) {
+      juce::AudioBuffer<float> block(work.getArrayOfWritePointers(),
+                                     numChannels, offset,
+                                     juce::jmin(blockSize, numSamples - offset));
+      engine.process(block);
+    }
+
+    const auto elapsed = juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - start);
+    best = juce::jmin(best, elapsed);
+  }
+
+  return best * 1.0e9 / (double)numSamples;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const int numRuns = argc > 1 ? juce::jmax(1, std::atoi(argv[1])) : 7;
+
+  const std::vector<Case> cases{
+      makeCase<PitchShifter>("grain"),
+      makeCase<PitchShifter>("grain 2 heads hann",
+                             [](PitchShifter &s) {
+                               s.setWindowShape(WindowShape::hann);
+                             }),
+      makeCase<PitchShifter>("grain 3 heads hann",
+                             [](PitchShifter &s) {
+                               s.setGrainHeads(3);
+                               s.setWindowShape(WindowShape::hann);
+                             }),
+      makeCase<PitchShifter>("grain 4 heads hann",
+                             [](PitchShifter &s) {
+                               s.setGrainHeads(4);
+                               s.setWindowShape(WindowShape::hann);
+                             }),
+      makeCase<PitchShifter>("grain 8 heads hann",
+                             [](PitchShifter &s) {
+                               s.setGrainHeads(8);
+                               s.setWindowShape(WindowShape::hann);
+                             }),
+      makeCase<PitchShifter>("grain + 4 voices",
+                             [](PitchShifter &s) {
+                               s.setHarmonyVoiceCount(4);
+                               for (int v = 0; v < 4; ++v)
+                                 s.setHarmonyVoice(v, voiceSemitones(v), 0.5f,
+                                                   0.0f);
+                             }),
+      makeCase<PitchShifter>("grain + 8 voices",
+                             [](PitchShifter &s) {
+                               s.setHarmonyVoiceCount(8);
+                               for (int v = 0; v < 8; ++v)
+                                 s.setHarmonyVoice(v, voiceSemitones(v), 0.5f,
+                                                   0.0f);
+                             }),
+      {"5 separate grains",
+       [] { return std::make_unique<SeparateShifters>(4); }},
+      makeCase<MultibandShifter>("multiband"),
+      makeCase<MultibandShifter>("multiband 4 heads hann",
+                                 [](MultibandShifter &s) {
+                                   s.setGrainHeads(4);
+                                   s.setWindowShape(WindowShape::hann);
+                                 }),
+      // 검출 주기를 넣지 않으면 prepare 의 기본 주기(200 Hz)에서 마크가
+      // 220 Hz 입력의 피크를 따라갑니다.
+      makeCase<PsolaShifter>("psola"),
+      makeCase<SpectralShifter>("spectral"),
+      makeCase<SpectralShifter>("spectral formant",
+                                [](SpectralShifter &s) {
+                                  s.setFormantPreservation(true);
+                                }),
+  };
+
+  const auto input = makeInput();
+
+  std::printf("ns/sample, %d ch @ %.0f Hz, +%.0f st, best of %d runs\n",
+              numChannels, sampleRate, (double)shiftSemitones, numRuns);
+  std::printf("%-28s", "block");
+  for (auto blockSize : blockSizes)
+    std::printf("%8d", blockSize);
+  std::printf("\n");
+
+  std::map<std::string, std::array<double, blockSizes.size()>> results;
+
+  for (const auto &c : cases) {
+    auto engine = c.create();
+    auto &row = results[c.name];
+    std::printf("%-28s", c.name);
+
+    for (size_t b = 0; b < blockSizes.size(); ++b) {
+      row[b] = measure(*engine, input, blockSizes[b], numRuns);
+      std::printf("%8.2f", row[b]);
+    }
+
+    std::printf("\n");
+  }
+
+  // 기준 엔진 대비 비용 (같은 블록 크기끼리 나눈 값)
+  const std::vector<std::pair<const char *, const char *>> ratios{
+      {"multiband", "grain"},
+      {"psola", "grain"},
+      {"spectral formant", "spectral"},
+  };
+
+  std::printf("\nratio\n");
+  for (const auto &[name, reference] : ratios) {
+    const auto label = juce::String(name) + " / " + reference;
+    std::printf("%-28s", label.toRawUTF8());
+
+    for (size_t b = 0; b < blockSizes.size(); ++b)
+      std::printf("%8.2f", results[name][b] / results[reference][b]);
+
+    std::printf("\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,187 @@
+#include "DSP/PitchShifter.h"
+#include "PluginProcessor.h"
+#include "TestSignals.h"
+
+#if JUCE_LINUX
+#include <malloc.h>
+#elif JUCE_MAC
+#include <malloc/malloc.h>
+#endif
+
+// 인스턴스당 메모리: 그레인 히스토리는 최대 그레인 + 탐색/보간 여유분을
+// 2의 거듭제곱으로 올린 크기이고, 채널은 버스에 있는 만큼만 잡습니다.
+// 세션에 인스턴스가 많을수록 이 크기가 그대로 곱해집니다.
+class FootprintTests : public juce::UnitTest {
+public:
+  FootprintTests() : juce::UnitTest("Memory footprint", "YAMMY") {}
+
+  void runTest() override {
+    // 100 ms 그레인 + 10 ms 탐색 + 3 ms 비교 구간 + 블록 + 보간 여유분은
+    // 192 kHz 에서 21700 샘플 남짓이므로 32768 로 올림됩니다.
+    beginTest("Grain history at 192 kHz holds one channel per bus channel");
+    {
+      // 보이스용 mid 채널은 아래에서 따로 봅니다.
+      PitchShifter mono;
+      PitchShifter stereo;
+      mono.setHarmonyCapacity(0);
+      stereo.setHarmonyCapacity(0);
+      mono.prepare(sampleRate, blockSize, 1);
+      stereo.prepare(sampleRate, blockSize, 2);
+
+      expectEquals(mono.getHistoryCapacity(), expectedHistory);
+      expectEquals(stereo.getHistoryCapacity(), expectedHistory);
+
+      // 채널 하나는 히스토리 한 채널과 믹스 행 하나를 더합니다.
+      const auto channelBytes =
+          (size_t)(expectedHistory + historyGuard) * sizeof(float);
+      const auto mixRowBytes = (size_t)chunkSize * sizeof(float);
+      expect(stereo.getFootprintBytes() - mono.getFootprintBytes() ==
+             channelBytes + mixRowBytes);
+
+      // 보이스가 없으면 블록 상태는 히스토리 한 채널보다 작습니다.
+      PitchShifter lean;
+      lean.setHarmonyCapacity(0);
+      lean.prepare(sampleRate, blockSize, 1);
+      expect(lean.getFootprintBytes() < 2 * channelBytes);
+    }
+
+    // 헤드 램프 행과 읽기 인덱스는 보이스들이 돌려 쓰므로 보이스 용량은
+    // 한 패스에 묶이는 보이스(최대 4개)의 채널 게인 행과, 스테레오 버스면
+    // 보이스가 읽는 mid 히스토리 채널 하나만 더합니다. 대역 시프터처럼
+    // 보이스를 쓰지 않는 소유자는 그마저 잡지 않습니다.
+    beginTest("Harmony capacity 0 allocates no voice rows");
+    {
+      PitchShifter withVoices;
+      PitchShifter withoutVoices;
+      withoutVoices.setHarmonyCapacity(0);
+      withVoices.prepare(sampleRate, blockSize, 2);
+      withoutVoices.prepare(sampleRate, blockSize, 2);
+
+      constexpr int voiceRows = 4 * 2;
+      const auto voiceBytes =
+          (size_t)chunkSize * (size_t)voiceRows * sizeof(float) +
+          (size_t)(expectedHistory + historyGuard) * sizeof(float);
+
+      expect(withVoices.getFootprintBytes() -
+                 withoutVoices.getFootprintBytes() ==
+             voiceBytes);
+
+      // 용량을 넘는 보이스는 켜지지 않아 출력이 그대로입니다.
+      PitchShifter reference;
+      reference.setHarmonyCapacity(0);
+      reference.prepare(sampleRate, blockSize, 2);
+
+      withoutVoices.setHarmonyVoiceCount(4);
+      withoutVoices.setHarmonyVoice(0, 7.0f, 1.0f, 0.0f);
+
+      auto input = TestSignals::makeNoise(2, 4 * blockSize);
+      auto output = input;
+      TestSignals::processInBlocks(withoutVoices, output, blockSize);
+      TestSignals::processInBlocks(reference, input, blockSize);
+
+      bool identical = true;
+      for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < input.getNumSamples(); ++i)
+          identical = identical && juce::exactlyEqual(output.getSample(ch, i),
+                                                      input.getSample(ch, i));
+
+      expect(identical);
+    }
+
+    // 스테레오 버스의 보이스는 좌우 평균(mid) 한 채널을 읽어 팬으로
+    // 나눕니다. 오른쪽에만 있는 입력도 왼쪽 끝으로 팬한 보이스로는 왼쪽에
+    // 나오고, 오른쪽 출력은 주 보이스만 있을 때와 같아야 합니다.
+    beginTest("Harmony voices read the mid channel and pan it");
+    {
+      PitchShifter panned;
+      PitchShifter reference;
+      reference.setHarmonyCapacity(0);
+      panned.setHarmonyVoiceCount(1);
+      panned.setHarmonyVoice(0, 7.0f, 1.0f, -1.0f);
+      panned.prepare(sampleRate, blockSize, 2);
+      reference.prepare(sampleRate, blockSize, 2);
+
+      auto input = TestSignals::makeNoise(2, (int)(sampleRate * 0.2));
+      input.clear(0, 0, input.getNumSamples());
+      auto output = input;
+      TestSignals::processInBlocks(panned, output, blockSize);
+      TestSignals::processInBlocks(reference, input, blockSize);
+
+      bool rightUnchanged = true;
+      for (int i = 0; i < input.getNumSamples(); ++i)
+        rightUnchanged = rightUnchanged &&
+                         juce::exactlyEqual(output.getSample(1, i),
+                                            input.getSample(1, i));
+
+      expect(rightUnchanged);
+      expectEquals(input.getMagnitude(0, 0, input.getNumSamples()), 0.0f);
+      expectGreaterThan(output.getMagnitude(0, 0, output.getNumSamples()),
+                        0.1f);
+    }
+
+    // 램프 행과 읽기 인덱스는 청크 크기로 잡히므로 호스트 블록이 커져도
+    // 히스토리의 블록 여유분 말고는 늘지 않습니다.
+    beginTest("Block state does not grow with the host block size");
+    {
+      PitchShifter small;
+      PitchShifter large;
+      small.prepare(sampleRate, chunkSize, 2);
+      large.prepare(sampleRate, 8192, 2);
+
+      expectEquals(large.getHistoryCapacity(), small.getHistoryCapacity());
+      expect(large.getFootprintBytes() == small.getFootprintBytes());
+    }
+
+    // 기본 설정(그레인 엔진, 고품질, 48 kHz 스테레오)의 프로세서 전체.
+    // 선택된 엔진만 준비되므로 다른 엔진의 FFT, 대역 시프터 등은 잡히지
+    // 않습니다. 힙 사용량은 할당기 통계로 잽니다 (지원하는 플랫폼에서만).
+    beginTest("Whole processor at default settings stays under its bound");
+    {
+      const juce::ScopedJuceInitialiser_GUI juce;
+      const auto before = getHeapBytesInUse();
+
+      auto processor = std::make_unique<YAMMYAudioProcessor>();
+      processor->setRateAndBufferSizeDetails(48000.0, 2048);
+      processor->prepareToPlay(48000.0, 2048);
+
+      expect(processor->isEnginePrepared(YAMMYAudioProcessor::grainEngine));
+      for (int engine = YAMMYAudioProcessor::spectralEngine;
+           engine < YAMMYAudioProcessor::numEngines; ++engine)
+        expect(!processor->isEnginePrepared(engine));
+
+      if (before > 0) {
+        const auto footprint = getHeapBytesInUse() - before;
+        logMessage("Processor footprint: " + juce::String(footprint) +
+                   " bytes");
+        expectLessThan(footprint, processorBound);
+      }
+    }
+  }
+
+private:
+  static constexpr double sampleRate = 192000.0;
+  static constexpr int blockSize = 512; // SIMD 폭의 배수라 패딩이 없습니다.
+  static constexpr int chunkSize = PitchShifter::maxChunkSize;
+  static constexpr int expectedHistory = 32768;
+  static constexpr int historyGuard = 8;
+
+  // 그레인 히스토리 (2 x 8192 샘플), 원음 딜레이, 피치 검출기, 파라미터
+  // 트리를 담을 만큼의 상한입니다.
+  static constexpr size_t processorBound = 512 * 1024;
+
+  // 지금 힙에서 쓰고 있는 바이트 수. 통계를 얻을 수 없으면 0 입니다.
+  static size_t getHeapBytesInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    const auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#elif JUCE_MAC
+    malloc_statistics_t stats{};
+    malloc_zone_statistics(nullptr, &stats);
+    return stats.size_in_use;
+#else
+    return 0;
+#endif
+  }
+};
+
+static FootprintTests footprintTests;
@@ -0,0 +1,82 @@
+#include "DSP/PitchShifter.h"
+#include "TestSignals.h"
+
+// GRAIN 자동화가 클릭 없이 들리는지 확인합니다. 그레인 길이는 상한 안에서
+// 목표로 램프하고 헤드 중심(레이턴시)은 상한에 고정이므로, 길이를 블록마다
+// 크게 바꿔도 출력은 사인의 기울기 안에서 이어지고 레이턴시는 그대로여야
+// 합니다. 길이나 딜레이가 한 번에 옮겨지면 그 샘플에서 출력이 튑니다.
+class GrainLengthTests : public juce::UnitTest {
+public:
+  GrainLengthTests() : juce::UnitTest("Grain length", "YAMMY") {}
+
+  void runTest() override {
+    beginTest("GRAIN automation over a sine has no discontinuity");
+    {
+      // 길이를 고정한 경우의 가장 큰 샘플 간 차이가 기준입니다. 가장 짧은
+      // 그레인이 윈도우 기울기가 가장 커서 차이도 가장 큽니다.
+      const float reference = render({PitchShifter::minGrainMs});
+      const float automated =
+          render({5.0f, 100.0f, 20.0f, 60.0f, 5.0f, 45.0f, 100.0f, 8.0f});
+
+      expectGreaterThan(reference, 0.0f);
+      expectLessThan(automated, reference * 1.25f);
+    }
+
+    beginTest("GRAIN automation keeps the latency fixed");
+    {
+      PitchShifter shifter;
+      shifter.prepare(sampleRate, blockSize, 1);
+      const int latency = shifter.getLatencySamples();
+
+      for (auto grainMs : {5.0f, 100.0f, 20.0f}) {
+        shifter.setGrainLength(grainMs);
+        expectEquals(shifter.getLatencySamples(), latency);
+      }
+    }
+  }
+
+private:
+  static constexpr double sampleRate = 48000.0;
+  static constexpr int blockSize = 64;
+  static constexpr int numSamples = 96000;
+  static constexpr int automationInterval = 4096;
+
+  // +5 반음으로 220 Hz 사인을 시프트하면서 automationInterval 마다 다음
+  // 그레인 길이로 바꾸고, 첫 0.5 초 뒤 출력의 가장 큰 샘플 간 차이를 돌려줍니다.
+  static float render(std::initializer_list<float> grainLengths) {
+    PitchShifter shifter;
+    shifter.setGrainLength(*grainLengths.begin());
+    shifter.prepare(sampleRate, blockSize, 1);
+    shifter.setPitch(5.0f);
+
+    juce::AudioBuffer<float> buffer(1, numSamples);
+    for (int i = 0; i < numSamples; ++i)
+      buffer.setSample(0, i,
+                       0.5f * std::sin(juce::MathConstants<float>::twoPi *
+                                       220.0f * (float)i / (float)sampleRate));
+
+    auto next = grainLengths.begin();
+
+    for (int offset = 0; offset < numSamples; offset += blockSize) {
+      if (offset % automationInterval == 0) {
+        shifter.setGrainLength(*next);
+        if (++next == grainLengths.end())
+          next = grainLengths.begin();
+      }
+
+      juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), 1,
+                                     offset,
+                                     juce::jmin(blockSize, numSamples - offset));
+      shifter.process(block);
+    }
+
+    float worst = 0.0f;
+    for (int i = (int)sampleRate / 2; i < numSamples; ++i)
+      worst = juce::jmax(worst, std::abs(buffer.getSample(0, i) -
+                                         buffer.getSample(0, i - 1)));
+
+    return worst;
+  }
+};
+
+static GrainLengthTests grainLengthTests;
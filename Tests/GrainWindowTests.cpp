@@ -0,0 +1,52 @@
+#include "DSP/PitchShifter.h"
+#include "TestSignals.h"
+
+// 윈도우 형태와 헤드 수의 모든 조합에서 겹친 윈도우의 합이 1인지 확인합니다.
+// 삼각형(짝수 헤드)과 Hann 은 해석적으로, 나머지는 정규화 테이블로 게인을
+// 구하므로, 시프트 중인 DC 입력의 출력이 입력 레벨에 평탄해야 합니다.
+// 허용 편차(-60 dB)는 테이블 선형 보간 오차(삼각형 3헤드에서 약 6e-4)입니다.
+class GrainWindowTests : public juce::UnitTest {
+public:
+  GrainWindowTests() : juce::UnitTest("Grain windows", "YAMMY") {}
+
+  void runTest() override {
+    beginTest("Overlapping windows sum to unity for every shape and head count");
+    {
+      for (auto shape : {WindowShape::triangle, WindowShape::hann,
+                         WindowShape::tukey})
+        for (auto heads : grainHeadCounts)
+          expectLessThan(measureRipple(shape, heads), 1.0e-3f,
+                         "shape " + juce::String((int)shape) + ", " +
+                             juce::String(heads) + " heads");
+    }
+  }
+
+private:
+  static constexpr double sampleRate = 48000.0;
+  static constexpr int blockSize = 256;
+  static constexpr float level = 0.5f;
+
+  // 레이턴시가 지난 뒤 출력이 DC 레벨에서 벗어난 최대 상대 편차
+  static float measureRipple(WindowShape shape, int heads) {
+    PitchShifter shifter;
+    shifter.setGrainHeads(heads);
+    shifter.setWindowShape(shape);
+    shifter.prepare(sampleRate, blockSize, 1);
+    shifter.setPitch(5.0f);
+    shifter.reset();
+
+    juce::AudioBuffer<float> buffer(1, (int)sampleRate / 2);
+    juce::FloatVectorOperations::fill(buffer.getWritePointer(0), level,
+                                      buffer.getNumSamples());
+    TestSignals::processInBlocks(shifter, buffer, blockSize);
+
+    float worst = 0.0f;
+    for (int i = 2 * shifter.getMaxLatencySamples(); i < buffer.getNumSamples();
+         ++i)
+      worst = juce::jmax(worst, std::abs(buffer.getSample(0, i) / level - 1.0f));
+
+    return worst;
+  }
+};
+
+static GrainWindowTests grainWindowTests;
@@ -0,0 +1,203 @@
+#include "DSP/HybridEngine.h"
+#include "DSP/MultibandShifter.h"
+#include "DSP/PitchShifter.h"
+#include "DSP/PsolaShifter.h"
+#include "DSP/SpectralShifter.h"
+#include "TestSignals.h"
+
+// 엔진이 보고하는 레이턴시가 실제 출력 위치와 맞는지 확인합니다.
+// 호스트 지연 보상과 원음 경로가 이 값에 그대로 맞춰지므로, 한 샘플만
+// 어긋나도 믹스에서 콤 필터가 생깁니다.
+class LatencyTests : public juce::UnitTest {
+public:
+  LatencyTests() : juce::UnitTest("Engine latency", "YAMMY") {}
+
+  void runTest() override {
+    beginTest("Grain engine output lands at the reported latency");
+    {
+      PitchShifter shifter;
+      for (auto blockSize : blockSizes) {
+        const int measured =
+            TestSignals::measureLatency(shifter, sampleRate, blockSize);
+        expectEquals(measured, shifter.getLatencySamples());
+      }
+    }
+
+    // 레이턴시는 상한으로만 정해집니다 (반 상한 + 보간 여유분). 프로세서는
+    // Low 모드에서 상한을 8 ms 로 둡니다.
+    beginTest("Grain engine latency follows the grain length limit");
+    {
+      for (auto grainMs : {8.0f, 20.0f, 45.0f}) {
+        PitchShifter shifter;
+        shifter.setGrainLength(grainMs);
+        shifter.setGrainLengthLimit(grainMs);
+
+        const int measured =
+            TestSignals::measureLatency(shifter, sampleRate, 256);
+        const int halfGrain = (int)std::ceil(sampleRate * grainMs / 1000.0) / 2;
+        expectEquals(shifter.getLatencySamples(),
+                     halfGrain + Interpolators::maxLookahead);
+        expectEquals(measured, shifter.getLatencySamples());
+      }
+    }
+
+    beginTest("Spectral engine output lands at the reported latency");
+    {
+      SpectralShifter shifter;
+      for (auto blockSize : blockSizes) {
+        const int measured =
+            TestSignals::measureLatency(shifter, sampleRate, blockSize);
+        expectEquals(measured, shifter.getLatencySamples());
+      }
+    }
+
+    // 마크 간격은 입력마다 다르지만, 피치 0 에서는 그레인이 각 마크의
+    // 정확히 레이턴시 뒤에 놓여야 합니다.
+    beginTest("PSOLA output lands at the reported latency for any block size");
+    {
+      PsolaShifter shifter;
+      for (auto blockSize : blockSizes) {
+        const int measured =
+            TestSignals::measureLatency(shifter, sampleRate, blockSize);
+        expectEquals(measured, shifter.getLatencySamples());
+      }
+    }
+
+    // 저지연 경로이므로 어느 샘플레이트에서든 10 ms 안쪽이어야 합니다.
+    beginTest("PSOLA latency stays under 10 ms");
+    {
+      for (auto rate : {44100.0, 48000.0, 96000.0, 192000.0}) {
+        PsolaShifter shifter;
+        shifter.prepare(rate, 256, 1);
+        expectLessThan(shifter.getLatencySamples(), (int)(rate * 0.01));
+      }
+    }
+
+    // 기타와 남성 보컬 음역은 주기가 5 ms 를 넘습니다. 그레인이 두 주기를
+    // 덮지 못하거나 마크가 늦으면 피치 0 에서도 원음과 달라집니다.
+    beginTest("PSOLA passes a 110 Hz tone unchanged at 0 semitones");
+    {
+      for (auto blockSize : {64, 256, 1000}) {
+        PsolaShifter shifter;
+        shifter.prepare(sampleRate, blockSize, 1);
+        shifter.setPitch(0.0f);
+        shifter.setDetectedPeriod((float)(sampleRate / 110.0), 1.0f);
+
+        const int numSamples = 16384;
+        const auto input =
+            TestSignals::makeHarmonicTone(1, numSamples, 110.0, sampleRate);
+        auto output = input;
+        TestSignals::processInBlocks(shifter, output, blockSize);
+
+        // 처음 몇 주기는 마크가 쌓이는 구간이라 뺍니다.
+        const int latency = shifter.getLatencySamples();
+        const int start = 4096;
+        double error = 0.0, power = 0.0;
+
+        for (int i = start; i < numSamples; ++i) {
+          const double x = input.getSample(0, i - latency);
+          const double d = output.getSample(0, i) - x;
+          error += d * d;
+          power += x * x;
+        }
+
+        expectLessThan(std::sqrt(error / power), 0.01);
+      }
+    }
+
+    // 프로세서는 준비하지 않은 엔진의 레이턴시를 모르므로 원음 딜레이를
+    // PitchEngine::maxLatencySeconds 로 잡습니다. 모든 엔진이 어느
+    // 샘플레이트에서든 그 안에 들어야 합니다.
+    beginTest("Every engine's latency fits the shared latency bound");
+    {
+      for (auto rate : {22050.0, 32000.0, 44100.0, 48000.0, 88200.0, 96000.0,
+                        176400.0, 192000.0}) {
+        PitchShifter grain;
+        SpectralShifter spectral;
+        PsolaShifter psola;
+        MultibandShifter multiband;
+        std::array<PitchEngine *, 4> engines{&grain, &spectral, &psola,
+                                             &multiband};
+
+        const int bound = (int)std::ceil(rate * PitchEngine::maxLatencySeconds);
+        for (auto *engine : engines) {
+          engine->prepare(rate, 256, 2);
+          expectLessOrEqual(engine->getMaxLatencySamples(), bound);
+        }
+      }
+    }
+
+    // 모노 버스에서는 히스토리와 누산이 한 채널뿐이므로 두 번째 채널을
+    // 건드리지 않아야 합니다. 마크는 좌우 합의 최댓값에 찍히므로 좌우가
+    // 같은 스테레오 입력의 한 채널과 출력이 같아야 합니다.
+    beginTest("PSOLA on a mono bus matches one channel of a stereo bus");
+    {
+      PsolaShifter mono;
+      PsolaShifter stereo;
+      mono.prepare(sampleRate, 256, 1);
+      stereo.prepare(sampleRate, 256, 2);
+
+      for (auto *shifter : {&mono, &stereo}) {
+        shifter->setPitch(5.0f);
+        shifter->setDetectedPeriod((float)(sampleRate / 220.0), 1.0f);
+      }
+
+      auto monoBuffer = TestSignals::makeNoise(1, 8192);
+      juce::AudioBuffer<float> stereoBuffer(2, monoBuffer.getNumSamples());
+      for (int ch = 0; ch < 2; ++ch)
+        stereoBuffer.copyFrom(ch, 0, monoBuffer, 0, 0,
+                              monoBuffer.getNumSamples());
+
+      TestSignals::processInBlocks(mono, monoBuffer, 256);
+      TestSignals::processInBlocks(stereo, stereoBuffer, 256);
+
+      bool identical = true;
+      for (int i = 0; i < monoBuffer.getNumSamples(); ++i)
+        identical = identical && juce::exactlyEqual(monoBuffer.getSample(0, i),
+                                                    stereoBuffer.getSample(0, i));
+
+      expect(identical);
+      expectGreaterThan(monoBuffer.getMagnitude(0, 0, 8192), 0.0f);
+    }
+
+    // 저역은 하프밴드 두 단을 거치므로 홀수 블록에서 데시메이션 위상이
+    // 블록 경계를 넘어가도 어긋나지 않는지 함께 봅니다.
+    beginTest("Multiband output lands at the reported latency, odd blocks too");
+    {
+      MultibandShifter shifter;
+      for (auto blockSize : {32, 333, 1000, 2047}) {
+        const int measured =
+            TestSignals::measureLatency(shifter, sampleRate, blockSize);
+        expectEquals(measured, shifter.getLatencySamples());
+      }
+    }
+
+    // 그레인 엔진 출력은 스펙트럼 엔진 레이턴시에 맞춰 지연되므로, 어느
+    // 엔진이 돌든(주기성 1: 그레인 유지, 0: 스펙트럼으로 전환) 같은
+    // 레이턴시에 나와야 합니다.
+    beginTest("Hybrid engine keeps one latency across engine switches");
+    {
+      PitchShifter grain;
+      SpectralShifter spectral;
+      HybridEngine hybrid(grain, spectral);
+
+      for (auto periodicity : {1.0f, 0.0f}) {
+        grain.prepare(sampleRate, 256, 1);
+        spectral.prepare(sampleRate, 256, 1);
+        hybrid.setPeriodicity(periodicity);
+
+        const int measured =
+            TestSignals::measureLatency(hybrid, sampleRate, 256);
+        expectEquals(hybrid.getLatencySamples(), spectral.getLatencySamples());
+        expectEquals(measured, hybrid.getLatencySamples());
+        expect(hybrid.isPolyphonic() == (periodicity < 0.5f));
+      }
+    }
+  }
+
+private:
+  static constexpr double sampleRate = 48000.0;
+  static constexpr std::array<int, 4> blockSizes{32, 256, 1000, 2048};
+};
+
+static LatencyTests latencyTests;
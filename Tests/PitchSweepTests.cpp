@@ -0,0 +1,124 @@
+#include "DSP/FastMath.h"
+#include "DSP/PitchShifter.h"
+#include "TestSignals.h"
+
+// 음정 램프가 샘플 단위로 이어지는지, 그리고 그 비율 계산에 쓰는 빠른
+// exp2 가 충분히 정확한지 확인합니다.
+class PitchSweepTests : public juce::UnitTest {
+public:
+  PitchSweepTests() : juce::UnitTest("Pitch sweep", "YAMMY") {}
+
+  void runTest() override {
+    beginTest("semitonesToRatio matches std::pow within 0.1 cent over +-48 st");
+    {
+      std::vector<float> semitones;
+      for (int i = -48000; i <= 48000; ++i)
+        semitones.push_back((float)i * 0.001f);
+
+      // 블록 버전(엔진이 램프에 쓰는 경로)도 같은 격자로 봅니다.
+      std::vector<float> block(semitones.size());
+      for (size_t i = 0; i < semitones.size(); ++i)
+        block[i] = semitones[i] * (1.0f / 12.0f);
+
+      FastMath::exp2(block.data(), block.data(), (int)block.size());
+
+      double worstCents = 0.0;
+      for (size_t i = 0; i < semitones.size(); ++i) {
+        const double exact = std::pow(2.0, (double)semitones[i] / 12.0);
+
+        for (auto ratio : {FastMath::semitonesToRatio(semitones[i]), block[i]})
+          worstCents = juce::jmax(
+              worstCents, std::abs(1200.0 * std::log2((double)ratio / exact)));
+      }
+
+      expectLessThan(worstCents, 0.1);
+    }
+
+    // 샘플마다 램프를 따르면 청크를 어디서 나누든 출력이 같아야 합니다.
+    // 블록마다 음정을 한 번 정하거나 청크 경계에서 위상이 튀면 달라집니다.
+    beginTest("Pitch sweep output does not depend on the block size");
+    {
+      const auto reference = renderSweep(TestSignals::makeNoise(1, numSamples),
+                                         1024);
+
+      for (auto blockSize : {37, 256}) {
+        const auto output =
+            renderSweep(TestSignals::makeNoise(1, numSamples), blockSize);
+
+        float worst = 0.0f;
+        for (int i = 0; i < numSamples; ++i)
+          worst = juce::jmax(worst, std::abs(output.getSample(0, i) -
+                                             reference.getSample(0, i)));
+
+        expectLessThan(worst, 1.0e-4f);
+      }
+    }
+
+    // 선형 입력 x[n] = n / fs 는 선형 보간으로 정확히 읽히므로 출력은
+    // x[n] - D[n] / fs 이고, D 는 헤드 딜레이의 게인 가중합입니다.
+    // 두 헤드 hann 에서 D = L (x - sin^2(pi x) / 2) (x 는 헤드 위상) 이라
+    // 샘플당 기울기는 1 + (r - 1)(1 - (pi / 2) sin(2 pi x)), 즉 그 샘플의
+    // 비율 r 로 정해지는 범위 안에 있어야 합니다. 램프를 건너뛰거나 블록
+    // 단위로 계단을 만들거나 위상이 튀면 그 샘플에서 범위를 벗어납니다.
+    // (삼각형 윈도우는 D 가 상수라 위상을 볼 수 없습니다.)
+    beginTest("Pitch sweep follows the ramp at every sample");
+    {
+      juce::AudioBuffer<float> input(1, numSamples);
+      for (int i = 0; i < numSamples; ++i)
+        input.setSample(0, i, (float)i / (float)sampleRate);
+
+      const auto output = renderSweep(input, 256, WindowShape::hann);
+      constexpr float halfPi = juce::MathConstants<float>::halfPi;
+
+      float worstExcess = 0.0f;
+
+      for (int i = sweepStart + 1; i < numSamples; ++i) {
+        const float progress =
+            juce::jlimit(0.0f, 1.0f, (float)(i - sweepStart) / sweepSamples);
+        const float ratio = std::pow(2.0f, progress * sweepSemitones / 12.0f);
+        const float lowest = 1.0f - (halfPi - 1.0f) * (ratio - 1.0f);
+        const float highest = 1.0f + (halfPi + 1.0f) * (ratio - 1.0f);
+
+        const float slope =
+            (output.getSample(0, i) - output.getSample(0, i - 1)) *
+            (float)sampleRate;
+        worstExcess =
+            juce::jmax(worstExcess, lowest - slope, slope - highest);
+      }
+
+      expectLessThan(worstExcess, slopeTolerance);
+    }
+  }
+
+private:
+  static constexpr double sampleRate = 48000.0;
+  static constexpr int numSamples = 16384;
+  static constexpr int sweepStart = 4096;
+  static constexpr int sweepSamples = 4800;
+  static constexpr float sweepSemitones = 12.0f;
+  static constexpr float slopeTolerance = 0.01f;
+
+  // sweepStart 에서 0 -> sweepSemitones 램프를 거는 그레인 엔진 출력
+  static juce::AudioBuffer<float>
+  renderSweep(juce::AudioBuffer<float> buffer, int blockSize,
+              WindowShape shape = WindowShape::triangle) {
+    PitchShifter shifter;
+    shifter.setWindowShape(shape);
+    shifter.prepare(sampleRate, blockSize, 1);
+    shifter.setPitch(0.0f);
+    shifter.reset();
+
+    juce::AudioBuffer<float> before(buffer.getArrayOfWritePointers(), 1, 0,
+                                    sweepStart);
+    juce::AudioBuffer<float> after(buffer.getArrayOfWritePointers(), 1,
+                                   sweepStart, numSamples - sweepStart);
+
+    TestSignals::processInBlocks(shifter, before, blockSize);
+    shifter.setPitch(sweepSemitones, sweepSamples);
+    TestSignals::processInBlocks(shifter, after, blockSize);
+
+    return buffer;
+  }
+};
+
+static PitchSweepTests pitchSweepTests;
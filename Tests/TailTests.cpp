@@ -0,0 +1,107 @@
+#include "DSP/HybridEngine.h"
+#include "DSP/MultibandShifter.h"
+#include "DSP/PitchShifter.h"
+#include "DSP/PsolaShifter.h"
+#include "DSP/SpectralShifter.h"
+#include "TestSignals.h"
+
+// 엔진이 보고하는 꼬리가 실제로 출력이 끝나는 지점을 덮는지 확인합니다.
+// 프로세서는 입력이 꼬리보다 오래 무음이면 엔진을 재우고 호스트에도 같은
+// 값을 꼬리 길이로 보고하므로, 꼬리가 짧으면 소리 끝이 잘립니다.
+class TailTests : public juce::UnitTest {
+public:
+  TailTests() : juce::UnitTest("Engine tail", "YAMMY") {}
+
+  void runTest() override {
+    beginTest("Grain engine output ends within the reported tail");
+    {
+      PitchShifter shifter;
+      shifter.prepare(sampleRate, blockSize, 1);
+      for (auto semitones : pitches)
+        checkTail(shifter, semitones);
+    }
+
+    beginTest("Spectral engine output ends within the reported tail");
+    {
+      SpectralShifter shifter;
+      shifter.prepare(sampleRate, blockSize, 1);
+      for (auto semitones : pitches)
+        checkTail(shifter, semitones);
+    }
+
+    // 주기가 길수록 그레인이 길고, 입력이 아직 없는 마크 대신 한 주기 앞에서
+    // 자른 그레인이 가장 오래 남습니다. 포먼트 비율은 그레인이 읽는 입력
+    // 범위를 바꿉니다.
+    beginTest("PSOLA output ends within the reported tail");
+    {
+      for (auto frequency : {50.0, 110.0, 220.0}) {
+        for (auto formant : {-12.0f, 0.0f, 12.0f}) {
+          PsolaShifter shifter;
+          shifter.prepare(sampleRate, blockSize, 1);
+          shifter.setDetectedPeriod((float)(sampleRate / frequency), 1.0f);
+          shifter.setFormantShift(formant);
+
+          for (auto semitones : pitches)
+            checkTail(shifter, semitones);
+        }
+      }
+    }
+
+    beginTest("Multiband output ends within the reported tail");
+    {
+      MultibandShifter shifter;
+      shifter.prepare(sampleRate, blockSize, 1);
+      for (auto semitones : pitches)
+        checkTail(shifter, semitones);
+    }
+
+    // 주기성 1 은 그레인 엔진을 유지하고, 0 은 도중에 스펙트럼 엔진으로
+    // 넘어갑니다.
+    beginTest("Hybrid engine output ends within the reported tail");
+    {
+      for (auto periodicity : {1.0f, 0.0f}) {
+        PitchShifter grain;
+        SpectralShifter spectral;
+        HybridEngine hybrid(grain, spectral);
+        grain.prepare(sampleRate, blockSize, 1);
+        spectral.prepare(sampleRate, blockSize, 1);
+        hybrid.prepare(sampleRate, blockSize, 1);
+        hybrid.setPeriodicity(periodicity);
+
+        for (auto semitones : pitches)
+          checkTail(hybrid, semitones);
+      }
+    }
+  }
+
+private:
+  static constexpr double sampleRate = 48000.0;
+  static constexpr int blockSize = 256;
+  static constexpr int burstLength = 8192;
+  static constexpr std::array<float, 3> pitches{-12.0f, 0.0f, 7.0f};
+
+  // 잡음을 burstLength 동안 넣고 무음을 이어 붙여, 마지막 입력 뒤로 출력이
+  // 0 이 아닌 가장 늦은 샘플까지의 거리가 보고한 꼬리 안인지 봅니다.
+  void checkTail(PitchEngine &engine, float semitones) {
+    engine.setPitch(semitones);
+    engine.reset();
+
+    const int tail = engine.getTailSamples();
+    juce::AudioBuffer<float> buffer(1, burstLength + tail + 4 * blockSize);
+    buffer.clear();
+    buffer.copyFrom(0, 0, TestSignals::makeNoise(1, burstLength), 0, 0,
+                    burstLength);
+
+    TestSignals::processInBlocks(engine, buffer, blockSize);
+
+    int last = -1;
+    for (int i = 0; i < buffer.getNumSamples(); ++i)
+      if (!juce::exactlyEqual(buffer.getSample(0, i), 0.0f))
+        last = i;
+
+    expectGreaterThan(last, burstLength);
+    expectLessOrEqual(last - (burstLength - 1), tail);
+  }
+};
+
+static TailTests tailTests;
@@ -0,0 +1,16 @@
+#include <JuceHeader.h>
+
+// DSP 단위 테스트 러너 (콘솔).
+// "YAMMY" 분류의 테스트를 모두 돌리고, 실패가 하나라도 있으면 0 이 아닌
+// 값으로 끝나 CTest 가 실패로 잡습니다.
+int main() {
+  juce::UnitTestRunner runner;
+  runner.setAssertOnFailure(false);
+  runner.runTestsInCategory("YAMMY");
+
+  int failures = 0;
+  for (int i = 0; i < runner.getNumResults(); ++i)
+    failures += runner.getResult(i)->failures;
+
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "DSP/PitchEngine.h"
+#include <JuceHeader.h>
+
+// 테스트에서 함께 쓰는 입력 신호와 측정 도구.
+namespace TestSignals {
+// 재현 가능한 백색 잡음 (채널마다 같은 신호)
+inline juce::AudioBuffer<float> makeNoise(int numChannels, int numSamples,
+                                          juce::int64 seed = 1) {
+  juce::AudioBuffer<float> buffer(numChannels, numSamples);
+  juce::Random random(seed);
+
+  for (int i = 0; i < numSamples; ++i) {
+    const float x = random.nextFloat() * 2.0f - 1.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+      buffer.setSample(ch, i, x);
+  }
+
+  return buffer;
+}
+
+// 기본음과 배음 k 가 1/k 크기인 주기 신호 (채널마다 같은 신호)
+inline juce::AudioBuffer<float> makeHarmonicTone(int numChannels,
+                                                 int numSamples,
+                                                 double frequency,
+                                                 double sampleRate,
+                                                 int numHarmonics = 8) {
+  juce::AudioBuffer<float> buffer(numChannels, numSamples);
+
+  for (int i = 0; i < numSamples; ++i) {
+    double x = 0.0;
+    for (int k = 1; k <= numHarmonics; ++k)
+      x += std::sin(juce::MathConstants<double>::twoPi * frequency * k * i /
+                    sampleRate) /
+           k;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+      buffer.setSample(ch, i, (float)(0.4 * x));
+  }
+
+  return buffer;
+}
+
+// 버퍼 전체를 blockSize 단위로 제자리 처리합니다.
+inline void processInBlocks(PitchEngine &engine,
+                            juce::AudioBuffer<float> &buffer, int blockSize) {
+  const int numSamples = buffer.getNumSamples();
+
+  for (int offset = 0; offset < numSamples; offset += blockSize) {
+    juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(),
+                                   buffer.getNumChannels(), offset,
+                                   juce::jmin(blockSize, numSamples - offset));
+    engine.process(block);
+  }
+}
+
+// 입력과 출력의 상호상관이 최대인 지연 (첫 채널, 0..maxLag).
+// 잡음 입력이면 상관은 실제 지연에서만 뾰족하게 솟습니다.
+inline int findDelay(const juce::AudioBuffer<float> &input,
+                     const juce::AudioBuffer<float> &output, int maxLag,
+                     int windowLength) {
+  const float *x = input.getReadPointer(0);
+  const float *y = output.getReadPointer(0) + maxLag;
+  jassert(maxLag + windowLength <= output.getNumSamples());
+
+  int bestLag = 0;
+  double bestScore = -1.0;
+
+  for (int lag = 0; lag <= maxLag; ++lag) {
+    double score = 0.0;
+    for (int i = 0; i < windowLength; ++i)
+      score += (double)x[maxLag - lag + i] * (double)y[i];
+
+    if (score > bestScore) {
+      bestScore = score;
+      bestLag = lag;
+    }
+  }
+
+  return bestLag;
+}
+
+// 피치 0 으로 잡음을 통과시켜 측정한 엔진의 실제 레이턴시
+inline int measureLatency(PitchEngine &engine, double sampleRate,
+                          int blockSize) {
+  engine.prepare(sampleRate, blockSize, 1);
+  engine.setPitch(0.0f);
+  engine.reset();
+
+  const int maxLag = 2 * engine.getMaxLatencySamples() + blockSize;
+  const int windowLength = 8192;
+  const auto input = makeNoise(1, maxLag + windowLength);
+
+  auto output = input;
+  processInBlocks(engine, output, blockSize);
+
+  return findDelay(input, output, maxLag, windowLength);
+}
+} // namespace TestSignals